@@ -0,0 +1,817 @@
+// Benchmarks for the solvers. Build with `make bench`, then run ./bin/bench
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "../src/batch.h"
+#include "../src/constants.cpp"
+#include "../src/log.h"
+#include "../src/overview.h"
+#include "../src/packed_path.h"
+#include "../src/render.h"
+#include "../src/simulation.h"
+#include "../src/generators/recursive_backtracking.h"
+#include "../src/solvers/a_star_solver.h"
+#include "../src/solvers/depth_first_solver.h"
+#include "../src/solvers/frontier_solver.h"
+#include "../src/solvers/hierarchical_solver.h"
+#include "../src/solvers/incremental_planner.h"
+#include "../src/solvers/junction_graph.h"
+#include "../src/solvers/landmarks.h"
+#include "../src/solvers/memory_bounded_solver.h"
+#include "../src/solvers/naive_recursive_solver.h"
+#include "../src/solvers/solver_trace.h"
+#include "../src/solvers/tree_path_index.h"
+#include "../src/solvers/wall_follower.h"
+#include "../src/solvers/weighted_proximity_recursive.h"
+#include "../src/utils.h"
+#include "../src/video_export.h"
+#include "../src/viewer.h"
+#include "../src/wall_geometry.h"
+
+typedef std::chrono::steady_clock benchClock;
+
+static double millisecondsSince(const benchClock::time_point& begin) {
+    return std::chrono::duration<double, std::milli>(benchClock::now() - begin).count();
+}
+
+// Return a random location within a grid of the given size
+static utils::XY randomCell(std::mt19937& rng, const int rows, const int cols) {
+    return {std::uniform_int_distribution<int>(0, cols - 1)(rng), std::uniform_int_distribution<int>(0, rows - 1)(rng)};
+}
+
+// Return the length of the shortest path between two cells, found by a plain breadth first search over the grid
+static int flatBfsDistance(const utils::gridType& grid, const utils::XY& start, const utils::XY& end) {
+    std::vector<int> distance(grid.size() * grid[0].size(), -1);
+    std::vector<utils::XY> locationsToCheck = {start};
+    distance[utils::cellIndex(grid, start)] = 0;
+    for (std::size_t i = 0; i < locationsToCheck.size(); i++) {
+        const utils::XY origin = locationsToCheck[i];
+        if (origin == end) {
+            return distance[utils::cellIndex(grid, origin)];
+        }
+        for (const int direction : constants::DIRECTIONS) {
+            const utils::XY neighbor = utils::neighborOf(origin, direction);
+            if (utils::isConnected(grid, origin, direction) && distance[utils::cellIndex(grid, neighbor)] == -1) {
+                distance[utils::cellIndex(grid, neighbor)] = distance[utils::cellIndex(grid, origin)] + 1;
+                locationsToCheck.push_back(neighbor);
+            }
+        }
+    }
+    return -1;
+}
+
+// Compare the cells expanded per query by the naive solver with the nodes expanded on the junction graph
+void benchJunctionGraph(std::mt19937& rng) {
+    const int size = 100;
+    const int queries = 50;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    auto begin = benchClock::now();
+    const auto graph = jg::build(grid);
+    const double buildMs = millisecondsSince(begin);
+
+    long long naiveExpanded = 0, graphExpanded = 0;
+    double naiveMs = 0, graphMs = 0;
+    for (int i = 0; i < queries; i++) {
+        const auto start = randomCell(rng, size, size);
+        const auto end = randomCell(rng, size, size);
+
+        begin = benchClock::now();
+        ns::reset();
+        ns::solve(grid, start, end);
+        naiveMs += millisecondsSince(begin);
+        naiveExpanded += ns::visitedCount();
+
+        begin = benchClock::now();
+        const auto result = jg::solve(graph, grid, start, end);
+        graphMs += millisecondsSince(begin);
+        graphExpanded += result.nodesExpanded;
+    }
+
+    std::cout << "Junction graph, " << size << 'x' << size << " maze, " << queries << " queries\n"
+              << "  graph: " << graph.nodeCells.size() << " nodes, " << graph.edgeTargets.size() << " edges, built in "
+              << buildMs << " ms\n"
+              << "  ns::solve: " << naiveExpanded / queries << " cells expanded, " << naiveMs / queries
+              << " ms per query\n"
+              << "  jg::solve: " << graphExpanded / queries << " nodes expanded, " << graphMs / queries
+              << " ms per query\n"
+              << "  expansion ratio: " << (double)naiveExpanded / std::max(graphExpanded, 1LL) << "x\n";
+}
+
+// Measure point-to-point query throughput of the tree path index, against searching the junction graph
+void benchTreePathIndex(std::mt19937& rng) {
+    const int size = 1000;
+    const int queries = 1000000;
+    const int searches = 1000;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    auto begin = benchClock::now();
+    const auto index = tp::build(grid);
+    const double buildMs = millisecondsSince(begin);
+
+    std::vector<utils::XY> endpoints(2 * queries);
+    for (auto& endpoint : endpoints) {
+        endpoint = randomCell(rng, size, size);
+    }
+
+    begin = benchClock::now();
+    long long totalDistance = 0;
+    for (int i = 0; i < queries; i++) {
+        totalDistance += tp::distance(index, endpoints[2 * i], endpoints[2 * i + 1]);
+    }
+    const double distanceMs = millisecondsSince(begin);
+
+    begin = benchClock::now();
+    long long totalPathCells = 0;
+    for (int i = 0; i < searches; i++) {
+        totalPathCells += tp::path(index, endpoints[2 * i], endpoints[2 * i + 1]).length;
+    }
+    const double pathMs = millisecondsSince(begin);
+
+    const auto graph = jg::build(grid);
+    begin = benchClock::now();
+    for (int i = 0; i < searches; i++) {
+        jg::solve(graph, grid, endpoints[2 * i], endpoints[2 * i + 1]);
+    }
+    const double searchMs = millisecondsSince(begin);
+
+    std::cout << "Tree path index, " << size << 'x' << size << " maze\n"
+              << "  built in " << buildMs << " ms, " << index.levels << " ancestor levels\n"
+              << "  tp::distance: " << queries << " queries in " << distanceMs << " ms (mean distance "
+              << totalDistance / queries << ")\n"
+              << "  tp::path: " << searchMs / std::max(pathMs, 1e-9) << "x faster than jg::solve ("
+              << pathMs * 1000 / searches << " vs " << searchMs * 1000 / searches << " us per query, mean length "
+              << totalPathCells / searches << ")\n";
+}
+
+// Compare query latency of the hierarchical solver with a flat breadth first search, and with the weighted solver
+void benchHierarchicalSolver(std::mt19937& rng) {
+    const int size = 2000;
+    const int clusterSize = 32;
+    const int queries = 20;
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    auto begin = benchClock::now();
+    const auto graph = hp::build(grid, clusterSize, 1);
+    const double buildMs = millisecondsSince(begin);
+    begin = benchClock::now();
+    hp::build(grid, clusterSize, threads);
+    const double parallelBuildMs = millisecondsSince(begin);
+
+    double hierarchicalMs = 0, flatMs = 0;
+    for (int i = 0; i < queries; i++) {
+        const auto start = randomCell(rng, size, size);
+        const auto end = randomCell(rng, size, size);
+
+        begin = benchClock::now();
+        const auto result = hp::solve(graph, grid, start, end);
+        hierarchicalMs += millisecondsSince(begin);
+
+        begin = benchClock::now();
+        const int distance = flatBfsDistance(grid, start, end);
+        flatMs += millisecondsSince(begin);
+        if (distance != result.path.length - 1) {
+            std::cerr << "hp::solve and breadth first search disagree on the distance\n";
+        }
+    }
+
+    // The weighted solver records every visit for its animation, so it's only compared on a smaller maze
+    const int smallSize = 100;
+    auto smallGrid = utils::createEmptyGrid(smallSize, smallSize);
+    rb::generateMazeIteratively(&smallGrid, rng);
+    const auto smallGraph = hp::build(smallGrid, clusterSize, threads);
+    double smallHierarchicalMs = 0, weightedMs = 0;
+    for (int i = 0; i < queries; i++) {
+        const auto start = randomCell(rng, smallSize, smallSize);
+        const auto end = randomCell(rng, smallSize, smallSize);
+
+        begin = benchClock::now();
+        hp::solve(smallGraph, smallGrid, start, end);
+        smallHierarchicalMs += millisecondsSince(begin);
+
+        begin = benchClock::now();
+        ws::reset();
+        ws::solve(smallGrid, start, end);
+        weightedMs += millisecondsSince(begin);
+    }
+
+    std::cout << "Hierarchical solver, " << size << 'x' << size << " maze, " << clusterSize << 'x' << clusterSize
+              << " clusters, " << queries << " queries\n"
+              << "  abstract graph: " << graph.nodeCells.size() << " nodes, " << graph.edgeTargets.size()
+              << " edges, built in " << buildMs << " ms (" << parallelBuildMs << " ms on " << threads << " threads)\n"
+              << "  hp::solve: " << hierarchicalMs / queries << " ms per query\n"
+              << "  flat BFS: " << flatMs / queries << " ms per query\n"
+              << "  on a " << smallSize << 'x' << smallSize << " maze, hp::solve: " << smallHierarchicalMs / queries
+              << " ms per query, ws::solve: " << weightedMs / queries << " ms per query\n";
+}
+
+// Compare re-planning after a single wall edit against planning from scratch, on a maze of a million cells
+void benchIncrementalPlanner(std::mt19937& rng) {
+    const int size = 1000;
+    const int edits = 200;
+    // Planning from scratch is slow, so it's only timed for some of the edits
+    const int scratchEvery = 20;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    ip::planner plan;
+    ip::initialize(plan, grid, {0, 0}, {size - 1, size - 1});
+    ip::attach(plan);
+    auto begin = benchClock::now();
+    ip::path(plan);
+    const double initialMs = millisecondsSince(begin);
+    const long long initialExpansions = plan.expansions;
+
+    double replanMs = 0, maxReplanMs = 0, scratchMs = 0;
+    int scratchRuns = 0;
+    for (int i = 0; i < edits; i++) {
+        // Toggle a random wall. Opening walls adds loops, and closing them may cut the maze in two.
+        const auto origin = randomCell(rng, size - 1, size - 1);
+        const int direction = (i % 2 == 0) ? constants::EAST : constants::SOUTH;
+        utils::setWall(grid, origin, direction, !utils::isConnected(grid, origin, direction));
+
+        begin = benchClock::now();
+        const auto path = ip::path(plan);
+        const double ms = millisecondsSince(begin);
+        replanMs += ms;
+        maxReplanMs = std::max(maxReplanMs, ms);
+
+        if (i % scratchEvery == 0) {
+            ip::planner fresh;
+            ip::initialize(fresh, grid, {0, 0}, {size - 1, size - 1});
+            begin = benchClock::now();
+            const auto freshPath = ip::path(fresh);
+            scratchMs += millisecondsSince(begin);
+            scratchRuns++;
+            if (freshPath.length != path.length) {
+                std::cerr << "Incremental and from-scratch plans disagree on the distance\n";
+            }
+        }
+    }
+    ip::detach(plan);
+
+    std::cout << "Incremental planner, " << size << 'x' << size << " maze, " << edits << " single wall edits\n"
+              << "  initial plan: " << initialMs << " ms, " << initialExpansions << " expansions\n"
+              << "  re-plan after an edit: " << replanMs / edits << " ms mean, " << maxReplanMs << " ms max, "
+              << (plan.expansions - initialExpansions) / edits << " expansions mean\n"
+              << "  plan from scratch: " << scratchMs / scratchRuns << " ms\n";
+}
+
+// Record a long wall follower walk as a packed path, and compare its size against storing every cell as an XY
+void benchPackedPath(std::mt19937& rng) {
+    const int size = 3000;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    std::ostringstream discarded;
+    auto* const coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+    pp::packedPath route;
+    auto begin = benchClock::now();
+    const auto report =
+        wf::solve(utils::readerFor(grid), {0, 0}, {size - 1, size - 1}, constants::LEFT_HAND, &route);
+    const double walkMs = millisecondsSince(begin);
+    lg::flush();
+    std::cout.rdbuf(coutBuffer);
+
+    begin = benchClock::now();
+    long long checksum = 0;
+    for (const utils::XY& cell : route) {
+        checksum += cell.x ^ cell.y;
+    }
+    const double decodeMs = millisecondsSince(begin);
+
+    const char* filename = "bench_packed_path.bin";
+    begin = benchClock::now();
+    pp::writePath(route, filename);
+    const double writeMs = millisecondsSince(begin);
+    begin = benchClock::now();
+    const bool roundTripped = pp::readPath(filename) == route;
+    const double readMs = millisecondsSince(begin);
+    std::remove(filename);
+    if (!roundTripped) {
+        std::cerr << "The packed path changed on its way through a file\n";
+    }
+
+    std::cout << "Packed path, wall follower on a " << size << 'x' << size << " maze (checksum " << checksum << ")\n"
+              << "  walked " << report.steps << " steps in " << walkMs << " ms, leaving a path of " << route.length
+              << " cells\n"
+              << "  packed: " << route.steps.size() / 1024 << " KB, as XYs: "
+              << route.length * (long long)sizeof(utils::XY) / 1024 << " KB\n"
+              << "  decoding every cell: " << decodeMs << " ms, writing: " << writeMs << " ms, reading: " << readMs
+              << " ms\n";
+}
+
+// Compare how long the naive solver takes to make its first visit when stepped through lazily, as the animation does,
+// against solving the whole maze first. Also compare the cost of stepping through the whole search against solving it.
+void benchSolverSteps(std::mt19937& rng) {
+    const int size = 2000;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+    const utils::XY start = {0, 0};
+    const utils::XY end = {size - 1, size - 1};
+
+    auto begin = benchClock::now();
+    ns::reset();
+    ns::solve(grid, start, end);
+    const double solveMs = millisecondsSince(begin);
+    const int visits = ns::visitedCount();
+    ns::reset();
+
+    begin = benchClock::now();
+    auto walk = ns::steps(grid, start, end);
+    auto visit = walk.begin();
+    const double firstVisitMs = millisecondsSince(begin);
+    long long checksum = 0;
+    for (; visit != walk.end(); ++visit) {
+        checksum += (*visit).taskCount;
+    }
+    const double stepMs = millisecondsSince(begin);
+
+    std::cout << "Lazy solver steps, " << size << 'x' << size << " maze, " << visits << " visits\n"
+              << "  first visit after: " << firstVisitMs << " ms, where solving first takes " << solveMs << " ms\n"
+              << "  stepping through every visit: " << stepMs << " ms (checksum " << checksum << ")\n";
+}
+
+// Compare the cells expanded by IDA* and fringe search against the cells a breadth first search visits, in a perfect
+// maze, and in the same maze with some walls knocked through. Without a transposition table, the number of routes the
+// searches try grows exponentially with the number of loops, so they're only run with one there.
+void benchMemoryBoundedSolvers(std::mt19937& rng) {
+    const int size = 100;
+    const int queries = 20;
+    const std::size_t tableBytes = 64 * 1024;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    for (const bool withLoops : {false, true}) {
+        if (withLoops) {
+            for (int i = 0; i < size * size / 50; i++) {
+                const utils::XY cell = randomCell(rng, size - 1, size - 1);
+                utils::setWall(grid, cell, rng() % 2 == 0 ? constants::EAST : constants::SOUTH, true);
+            }
+        }
+        const auto cells = utils::readerFor(grid);
+        long long bfsVisits = 0;
+        long long expansions[4] = {};
+        double ms[4] = {};
+        std::size_t peakNodes[4] = {};
+        for (int i = 0; i < queries; i++) {
+            const auto start = randomCell(rng, size, size);
+            const auto end = randomCell(rng, size, size);
+            ns::reset();
+            ns::solve(grid, start, end);
+            bfsVisits += ns::visitedCount();
+            for (int variant = withLoops ? 1 : 0; variant < 4; variant += withLoops ? 2 : 1) {
+                const std::size_t bytes = variant % 2 == 0 ? 0 : tableBytes;
+                const auto begin = benchClock::now();
+                const auto report =
+                    variant < 2 ? mb::idaStar(cells, start, end, bytes) : mb::fringeSearch(cells, start, end, bytes);
+                ms[variant] += millisecondsSince(begin);
+                expansions[variant] += report.expansions;
+                peakNodes[variant] = std::max(peakNodes[variant], report.peakNodes);
+            }
+        }
+        ns::reset();
+
+        std::cout << "Memory bounded solvers, " << size << 'x' << size << (withLoops ? " maze with loops, " : " maze, ")
+                  << queries << " queries, BFS visits " << bfsVisits / queries << " cells per query\n";
+        const char* names[4] = {"IDA*", "IDA* + 64 KB table", "fringe", "fringe + 64 KB table"};
+        for (int variant = withLoops ? 1 : 0; variant < 4; variant += withLoops ? 2 : 1) {
+            std::cout << "  " << names[variant] << ": " << expansions[variant] / queries << " expansions per query ("
+                      << (double)expansions[variant] / bfsVisits << "x BFS), " << ms[variant] / queries
+                      << " ms per query, at most " << peakNodes[variant] << " cells held\n";
+        }
+    }
+}
+
+// Compare the memory taken by a compact trace of each frontier search against storing every visit as an XY and an int
+template <typename Steps>
+static void benchTraceOf(const char* name, Steps&& steps) {
+    std::deque<utils::XY> cells = {};
+    std::vector<int> taskCounts = {};
+    auto begin = benchClock::now();
+    for (const st::stepEvent& visit : steps) {
+        cells.push_back(visit.cell);
+        taskCounts.push_back(visit.taskCount);
+    }
+    const double plainMs = millisecondsSince(begin);
+    const double plainBytes = cells.size() * sizeof(utils::XY) + taskCounts.capacity() * sizeof(int);
+
+    st::solveTrace trace = {};
+    begin = benchClock::now();
+    for (std::size_t i = 0; i < cells.size(); i++) {
+        st::recordVisit(trace, cells[i], taskCounts[i]);
+    }
+    const double recordMs = millisecondsSince(begin);
+
+    begin = benchClock::now();
+    long long checksum = 0;
+    st::forEachVisit(trace, st::size(trace), [&](const std::size_t i, const st::stepEvent& visit) {
+        checksum += visit.cell.x == cells[i].x && visit.cell.y == cells[i].y && visit.taskCount == taskCounts[i];
+    });
+    const double decodeMs = millisecondsSince(begin);
+    if (checksum != (long long)cells.size()) {
+        std::cerr << "The trace doesn't decode to the visits recorded into it\n";
+    }
+
+    std::cout << "  " << name << ": " << cells.size() << " visits, " << st::memoryBytes(trace) / 1024 << " KB ("
+              << (double)st::memoryBytes(trace) / cells.size() << " bytes per visit), against "
+              << (long long)plainBytes / 1024 << " KB: " << plainBytes / st::memoryBytes(trace) << "x smaller\n"
+              << "    recording: " << recordMs << " ms (plain: " << plainMs << " ms including the search), decoding: "
+              << decodeMs << " ms\n";
+}
+
+void benchSolveTrace(std::mt19937& rng) {
+    const int size = 3200;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+    const utils::XY start = {0, 0};
+    const utils::XY end = {size - 1, size - 1};
+
+    std::cout << "Solve traces, " << size << 'x' << size << " maze\n";
+    benchTraceOf("breadth first (ns)", ns::steps(grid, start, end));
+    benchTraceOf("best first (ws)", ws::steps(grid, start, end));
+    benchTraceOf("depth first (ds)", ds::steps(grid, start, end));
+}
+
+// Compare the time taken to draw the early frames of an animated search against the late ones, without a window. Only
+// the tail of recent visits is redrawn each frame, so late frames should cost no more than early ones.
+void benchTraceDraw(std::mt19937& rng) {
+    const int size = 60;
+    const int sampled = 200;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+    auto frame = rd::makeCanvas(size * constants::CELLWIDTH, size * constants::CELLHEIGHT);
+    rd::useCanvas(&frame);
+
+    std::vector<double> frameMs = {};
+    auto view = st::_openTraceView(grid);
+    for (const st::stepEvent& visit : ns::steps(grid, {0, 0}, {size - 1, size - 1})) {
+        const auto begin = benchClock::now();
+        st::_traceDraw(view, visit, {size - 1, size - 1}, false);
+        frameMs.push_back(millisecondsSince(begin));
+    }
+    st::_closeTraceView(view);
+    rd::useCanvas(nullptr);
+    ns::reset();
+
+    double earlyMs = 0, lateMs = 0;
+    for (int i = 0; i < sampled; i++) {
+        earlyMs += frameMs[i];
+        lateMs += frameMs[frameMs.size() - 1 - i];
+    }
+    std::cout << "Headless solver frames, " << size << 'x' << size << " maze, " << frame.width << 'x' << frame.height
+              << " pixels, " << frameMs.size() << " frames\n"
+              << "  first " << sampled << " frames: " << earlyMs / sampled << " ms per frame, last " << sampled
+              << ": " << lateMs / sampled << " ms per frame\n";
+}
+
+// Time headless solver frames of a window-sized canvas, for mazes from smaller than it to far larger, with the camera
+// still and with it panning every frame. Only the cells on screen are drawn, so the maze's size shouldn't matter.
+void benchViewport(std::mt19937& rng) {
+    const int frames = 200;
+    auto frame = rd::makeCanvas(constants::MAX_WINDOW_WIDTH, constants::MAX_WINDOW_HEIGHT);
+    rd::useCanvas(&frame);
+    std::cout << "Headless solver frames through the camera, " << frame.width << 'x' << frame.height << " pixels\n";
+    for (const int size : {30, 300, 3000}) {
+        auto grid = utils::createEmptyGrid(size, size);
+        rb::generateMazeIteratively(&grid, rng);
+        for (const bool panning : {false, true}) {
+            vw::reset();
+            auto view = st::_openTraceView(grid);
+            int drawn = 0;
+            double totalMs = 0;
+            for (const st::stepEvent& visit : ns::steps(grid, {0, 0}, {size - 1, size - 1})) {
+                if (panning) {
+                    rd::useCamera({{0, 0}, {(float)(drawn % 50), 0}, 0, 1});
+                }
+                const auto begin = benchClock::now();
+                st::_traceDraw(view, visit, {size - 1, size - 1}, false);
+                totalMs += millisecondsSince(begin);
+                if (++drawn == frames) {
+                    break;
+                }
+            }
+            const double frameMs = totalMs / drawn;
+            st::_closeTraceView(view);
+            ns::reset();
+            std::cout << "  " << size << 'x' << size << " maze, camera " << (panning ? "panning" : "still") << ": "
+                      << frameMs << " ms per frame\n";
+        }
+    }
+    vw::reset();
+    rd::useCanvas(nullptr);
+}
+
+// Time building a large maze's overview on one thread and on one per core, and drawing it with the whole maze in a
+// window-sized canvas, against drawing the cells themselves at the smallest zoom which still shows them
+void benchOverview(std::mt19937& rng) {
+    const int size = 3000;
+    const int frames = 20;
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    auto begin = benchClock::now();
+    ov::build(grid, 1);
+    const double singleMs = millisecondsSince(begin);
+    begin = benchClock::now();
+    ov::build(grid, threads);
+    const double parallelMs = millisecondsSince(begin);
+
+    auto frame = rd::makeCanvas(constants::MAX_WINDOW_WIDTH, constants::MAX_WINDOW_HEIGHT);
+    rd::useCanvas(&frame);
+    auto walls = wl::load(grid, BLACK);
+    // Fit the whole maze into the canvas, and then zoom in until each cell is a pixel
+    const float fitZoom = (float)frame.height / (size * constants::CELLHEIGHT);
+    double frameMs[2] = {0, 0};
+    for (const int detailed : {0, 1}) {
+        const float zoom = detailed ? 1.0f / constants::CELLHEIGHT : fitZoom;
+        for (int i = 0; i < frames; i++) {
+            // Pan a little every frame, so that nothing drawn for the last frame can be reused
+            rd::useCamera({{0, 0}, {(float)(i % 2) * constants::CELLWIDTH, 0}, 0, zoom});
+            begin = benchClock::now();
+            rd::clear(RAYWHITE);
+            wl::draw(walls);
+            frameMs[detailed] += millisecondsSince(begin) / frames;
+        }
+    }
+    wl::unload(walls);
+    vw::reset();
+    rd::useCanvas(nullptr);
+    std::cout << "Overview of a " << size << 'x' << size << " maze\n"
+              << "  built in " << singleMs << " ms on 1 thread, " << parallelMs << " ms on " << threads << '\n'
+              << "  whole maze in " << frame.width << 'x' << frame.height << " pixels: " << frameMs[0]
+              << " ms per frame from the overview, against " << frameMs[1] << " ms for cells of one pixel\n";
+}
+
+// Animate a breadth first search of a large maze into a window-sized canvas for a second, one visit per frame, and
+// again with the search on a simulation thread, running as fast as it can while frames are drawn of whatever it has
+// published. Compare how many visits each makes, and how many frames each draws.
+void benchSimulationThread(std::mt19937& rng) {
+    const int size = 1000;
+    const double runMs = 1000;
+    const utils::XY end = {size - 1, size - 1};
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+    auto frame = rd::makeCanvas(constants::MAX_WINDOW_WIDTH, constants::MAX_WINDOW_HEIGHT);
+    rd::useCanvas(&frame);
+    std::cout << "Animated breadth first search of a " << size << 'x' << size << " maze, " << frame.width << 'x'
+              << frame.height << " pixels, for " << runMs << " ms\n";
+
+    fs::search<fs::fifoFrontier> solver;
+    solver.begin(grid, {0, 0}, end);
+    auto view = st::_openTraceView(grid);
+    int frames = 0;
+    auto begin = benchClock::now();
+    st::stepEvent visit;
+    while (millisecondsSince(begin) < runMs && solver.nextStep(visit)) {
+        st::recordVisit(solver.trace, visit.cell, visit.taskCount);
+        st::_traceDraw(view, visit, end, false);
+        frames++;
+    }
+    st::_closeTraceView(view);
+    std::cout << "  one visit per frame: " << st::size(solver.trace) << " visits, " << frames << " frames\n";
+
+    solver.begin(grid, {0, 0}, end);
+    view = st::_openTraceView(grid);
+    sm::doubleBuffer<st::stepEvent> updates;
+    sm::update<st::stepEvent> latest;
+    sm::worker simulation;
+    simulation.start(
+        [&]() {
+            st::stepEvent next;
+            if (!solver.nextStep(next)) {
+                return false;
+            }
+            st::recordVisit(solver.trace, next.cell, next.taskCount);
+            updates.record(next);
+            return true;
+        },
+        [&]() { updates.publish(); }, 0);
+    frames = 0;
+    begin = benchClock::now();
+    while (millisecondsSince(begin) < runMs) {
+        updates.take(latest);
+        for (const st::stepEvent& published : latest.changes) {
+            st::_traceVisit(view, published);
+        }
+        if (view.visitCount > 0) {
+            st::_traceFrame(view, end, false);
+            frames++;
+        }
+    }
+    simulation.stop();
+    std::cout << "  simulation thread: " << st::size(solver.trace) << " visits, " << view.visitCount << " drawn, "
+              << frames << " frames, on " << std::thread::hardware_concurrency() << " cores\n";
+    st::_closeTraceView(view);
+    rd::useCanvas(nullptr);
+}
+
+// Stream the frames of an animated search into a Y4M and a GIF, and compare the cost of the first frame, which is
+// encoded whole, against the rest, of which only the rectangle around the cells that changed is encoded
+void benchVideoExport(std::mt19937& rng) {
+    const int size = 20;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+    auto frame = rd::makeCanvas(size * constants::CELLWIDTH, size * constants::CELLHEIGHT);
+    rd::useCanvas(&frame);
+    std::cout << "Video export of a " << size << 'x' << size << " maze's solver frames, " << frame.width << 'x'
+              << frame.height << " pixels\n";
+
+    // Each animation frame is marked with the cells it changes, so it's drawn, and written, as just that rectangle. For
+    // comparison, the same frames are also drawn and written whole.
+    for (const char* fileName : {"bench_video.y4m", "bench_video.gif"}) {
+        for (const bool marked : {true, false}) {
+            vx::videoStream video = {};
+            vx::open(video, fileName, frame.width, frame.height, constants::VIDEO_FPS);
+            double drawMs = 0, writeMs = 0;
+            long long dirtyPixels = 0;
+            auto view = st::_openTraceView(grid);
+            for (const st::stepEvent& visit : ns::steps(grid, {0, 0}, {size - 1, size - 1})) {
+                auto begin = benchClock::now();
+                if (marked) {
+                    rd::beginFrame();
+                }
+                st::_traceDraw(view, visit, {size - 1, size - 1}, false);
+                rd::endFrame();
+                drawMs += millisecondsSince(begin);
+                const rd::frameRect dirty = marked ? rd::dirtyRect() : rd::frameRect{0, 0, frame.width, frame.height};
+                dirtyPixels += (long long)(dirty.right - dirty.left) * (dirty.bottom - dirty.top);
+                begin = benchClock::now();
+                vx::writeFrame(video, frame, dirty);
+                writeMs += millisecondsSince(begin);
+            }
+            st::_closeTraceView(view);
+            ns::reset();
+            // Without beginFrame, nothing is marked, so later frames are drawn whole
+            rd::useCanvas(&frame);
+            const long long frames = video.frameCount;
+            vx::close(video);
+            std::ifstream written(fileName, std::ios::binary | std::ios::ate);
+            const long long bytes = written.tellg();
+            std::remove(fileName);
+            std::cout << "  " << fileName << (marked ? ", marked cells: " : ", whole frames: ") << frames << " frames, "
+                      << bytes / 1024 << " KB, " << 100.0 * dirtyPixels / ((double)frames * frame.width * frame.height)
+                      << "% of pixels changed, drawing " << drawMs / frames << " ms, writing " << writeMs / frames
+                      << " ms per frame\n";
+        }
+    }
+    rd::useCanvas(nullptr);
+}
+
+// Count the lines it takes to draw a maze's walls, one per cell side against one per straight run of walls, and time
+// building the segments and drawing both ways into a headless canvas
+void benchWallGeometry(std::mt19937& rng) {
+    const int size = 1000;
+    const int drawn = 100;
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+
+    auto begin = benchClock::now();
+    const auto geometry = wg::build(grid);
+    const double buildMs = millisecondsSince(begin);
+    std::size_t unitWalls = 0;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            unitWalls += !utils::isConnected(grid, {x, y}, constants::EAST);
+            unitWalls += !utils::isConnected(grid, {x, y}, constants::SOUTH);
+        }
+    }
+    std::ostringstream svg;
+    wg::writeSvg(geometry, svg, constants::CELLWIDTH, constants::CELLHEIGHT, RAYWHITE, BLACK);
+    std::cout << "Wall segments, " << size << 'x' << size << " recursive backtracker maze\n"
+              << "  " << unitWalls << " unit walls, " << wg::segmentCount(geometry) << " segments ("
+              << (double)unitWalls / wg::segmentCount(geometry) << "x fewer lines), built in " << buildMs << " ms, "
+              << svg.str().size() / 1024 << " KiB of SVG\n";
+
+    // Drawing, on a maze small enough to fit in a canvas
+    auto small = utils::createEmptyGrid(drawn, drawn);
+    rb::generateMazeIteratively(&small, rng);
+    auto frame = rd::makeCanvas(drawn * constants::CELLWIDTH + 1, drawn * constants::CELLHEIGHT + 1);
+    rd::useCanvas(&frame);
+    begin = benchClock::now();
+    for (int y = 0; y < drawn; y++) {
+        for (int x = 0; x < drawn; x++) {
+            const int left = x * constants::CELLWIDTH, top = y * constants::CELLHEIGHT;
+            const int right = left + constants::CELLWIDTH, bottom = top + constants::CELLHEIGHT;
+            if (!utils::isConnected(small, {x, y}, constants::EAST)) {
+                rd::line(right, top, right, bottom, BLACK);
+            }
+            if (!utils::isConnected(small, {x, y}, constants::SOUTH)) {
+                rd::line(left, bottom, right, bottom, BLACK);
+            }
+        }
+    }
+    const double perCellMs = millisecondsSince(begin);
+    begin = benchClock::now();
+    wg::forEachSegment(wg::build(small), constants::CELLWIDTH, constants::CELLHEIGHT,
+                       [](const int x0, const int y0, const int x1, const int y1) { rd::line(x0, y0, x1, y1, BLACK); });
+    const double mergedMs = millisecondsSince(begin);
+    rd::useCanvas(nullptr);
+    std::cout << "  drawing a " << drawn << 'x' << drawn << " maze headless: " << perCellMs << " ms per cell side, "
+              << mergedMs << " ms merged\n";
+}
+
+// Compare the cells A* visits, and the time it takes, with and without landmark distance bounds, in a maze with some
+// walls knocked through. Both find shortest paths. Also time building the landmark table, on one thread and on one per
+// core.
+void benchLandmarks(std::mt19937& rng) {
+    const int size = 1000;
+    const int landmarkCount = 8;
+    const int queries = 50;
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    auto grid = utils::createEmptyGrid(size, size);
+    rb::generateMazeIteratively(&grid, rng);
+    for (int i = 0; i < size * size / 50; i++) {
+        const utils::XY cell = randomCell(rng, size - 1, size - 1);
+        utils::setWall(grid, cell, rng() % 2 == 0 ? constants::EAST : constants::SOUTH, true);
+    }
+
+    auto begin = benchClock::now();
+    const auto table = lm::build(grid, landmarkCount);
+    const double selectMs = millisecondsSince(begin);
+    begin = benchClock::now();
+    const auto rebuilt = lm::build(grid, table.landmarks, threads);
+    const double rebuildMs = millisecondsSince(begin);
+    if (rebuilt.distance != table.distance) {
+        std::cerr << "The landmark table differs when built on several threads\n";
+    }
+
+    long long visits[2] = {};
+    double ms[2] = {};
+    long long lengths[2] = {};
+    for (int i = 0; i < queries; i++) {
+        const auto start = randomCell(rng, size, size);
+        const auto end = randomCell(rng, size, size);
+        for (const int withLandmarks : {0, 1}) {
+            as::useLandmarks(withLandmarks ? &table : nullptr);
+            as::reset();
+            const auto queryBegin = benchClock::now();
+            lengths[withLandmarks] = as::solve(grid, start, end).length;
+            ms[withLandmarks] += millisecondsSince(queryBegin);
+            visits[withLandmarks] += as::visitedCount();
+        }
+        if (lengths[0] != lengths[1]) {
+            std::cerr << "A* found paths of different lengths with and without landmarks\n";
+        }
+    }
+    as::useLandmarks(nullptr);
+    as::reset();
+
+    std::cout << "Landmarks, " << size << 'x' << size << " maze with loops, " << landmarkCount << " landmarks, "
+              << queries << " queries\n"
+              << "  choosing and measuring from landmarks: " << selectMs << " ms, measuring again on " << threads
+              << " threads: " << rebuildMs << " ms, table: "
+              << landmarkCount * (long long)size * size * sizeof(std::uint32_t) / 1024 << " KB\n"
+              << "  A*, Manhattan distance: " << visits[0] / queries << " visits, " << ms[0] / queries
+              << " ms per query\n"
+              << "  A*, landmark bound: " << visits[1] / queries << " visits, " << ms[1] / queries
+              << " ms per query (" << (double)visits[0] / visits[1] << "x fewer visits)\n";
+}
+
+// Compare batch throughput on one thread against one thread per core
+void benchBatch(std::mt19937& rng) {
+    const int jobs = 5000;
+    const int size = 32;
+    const int threads = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned seed = rng();
+
+    const auto serial = bt::run(jobs, size, size, 1, seed);
+    const auto parallel = bt::run(jobs, size, size, threads, seed);
+    bt::printSummary(serial, std::cout);
+    bt::printSummary(parallel, std::cout);
+    std::cout << "  speedup on " << threads << " threads: " << parallel.mazesPerSecond / serial.mazesPerSecond
+              << "x\n";
+}
+
+int main() {
+    std::mt19937 rng(std::random_device{}());
+    benchJunctionGraph(rng);
+    benchTreePathIndex(rng);
+    benchHierarchicalSolver(rng);
+    benchIncrementalPlanner(rng);
+    benchPackedPath(rng);
+    benchSolverSteps(rng);
+    benchMemoryBoundedSolvers(rng);
+    benchSolveTrace(rng);
+    benchTraceDraw(rng);
+    benchWallGeometry(rng);
+    benchViewport(rng);
+    benchOverview(rng);
+    benchSimulationThread(rng);
+    benchVideoExport(rng);
+    benchLandmarks(rng);
+    benchBatch(rng);
+    return 0;
+}
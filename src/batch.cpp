@@ -0,0 +1,137 @@
+// Generate and solve many mazes without a window, spread over a fixed pool of worker threads.
+// Each job generates a maze from its own seed, then finds the path from its top left to its bottom right corner. Every
+// worker owns one grid and one set of solver buffers, sized before its first job and reused for every job after that,
+// so the workers don't allocate, or contend for the allocator, once they're running. The only state the workers share is
+// the counter handing out the next job.
+
+#include "batch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "constants.cpp"
+#include "generators/recursive_backtracking.h"
+#include "packed_path.h"
+#include "solvers/distance_field.h"
+#include "utils.h"
+
+using namespace constants;
+using namespace utils;
+
+typedef std::chrono::steady_clock batchClock;
+
+// Everything a worker needs to run a job, kept from one job to the next
+struct workerBuffers {
+    gridType grid;
+    std::mt19937 rng;
+    rb::carveBuffers carve;
+    // The distance from each cell reached so far to the end location, and the first step towards it
+    df::distanceField field;
+    // The absolute indices of the cells reached so far, in the order they were reached
+    std::vector<int> locationsToCheck;
+    pp::packedPath path;
+};
+
+static double millisecondsBetween(const batchClock::time_point& begin, const batchClock::time_point& end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Breadth first search outwards from the end location until the start location is reached. Searching backwards means
+// the path can be read off forwards, by following the field from the start location. Returns the number of cells
+// visited.
+static int solveInto(workerBuffers& buffers, const XY& startLoc, const XY& endLoc) {
+    const int checked = df::computeInto(buffers.field, buffers.locationsToCheck, buffers.grid, endLoc, startLoc);
+    df::pathInto(buffers.path, buffers.field, startLoc);
+    return checked;
+}
+
+// Run the given number of jobs on the given number of threads. Job i uses the seed baseSeed + i. A thread count of 0
+// means one thread per core.
+bt::batchReport bt::run(const int jobCount, const int rows, const int cols, int threadCount, const unsigned baseSeed) {
+    if (rows < 1 || cols < 1)
+        throw std::invalid_argument("Mazes need at least one row and one column");
+    if (jobCount < 0 || threadCount < 0)
+        throw std::invalid_argument("The job and thread counts can't be negative");
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    batchReport report = {rows, cols, threadCount, std::vector<jobResult>(jobCount), 0, 0};
+    std::atomic<int> nextJob = 0;
+    const XY startLoc = {0, 0};
+    const XY endLoc = {cols - 1, rows - 1};
+
+    auto worker = [&](const int workerIdx) {
+        workerBuffers buffers = {createEmptyGrid(rows, cols), std::mt19937(), {}, {}, {}, pp::startingAt(startLoc)};
+        buffers.field.distance.reserve(rows * cols);
+        buffers.field.nextHop.reserve(rows * cols);
+        buffers.locationsToCheck.reserve(rows * cols);
+        buffers.path.steps.reserve(rows * cols / 4 + 1);
+
+        for (int job = nextJob++; job < jobCount; job = nextJob++) {
+            jobResult& result = report.jobs[job];
+            result.seed = baseSeed + job;
+            result.worker = workerIdx;
+
+            const auto begin = batchClock::now();
+            for (auto& row : buffers.grid) {
+                std::fill(row.begin(), row.end(), 0);
+            }
+            buffers.rng.seed(result.seed);
+            rb::generateMazeIteratively(&buffers.grid, buffers.rng, buffers.carve);
+            const auto generated = batchClock::now();
+            result.cellsVisited = solveInto(buffers, startLoc, endLoc);
+            const auto solved = batchClock::now();
+
+            result.found = buffers.path.length > 0;
+            result.pathLength = buffers.path.length;
+            result.generateMs = millisecondsBetween(begin, generated);
+            result.solveMs = millisecondsBetween(generated, solved);
+        }
+    };
+
+    const auto begin = batchClock::now();
+    std::vector<std::thread> threads = {};
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    report.elapsedMs = millisecondsBetween(begin, batchClock::now());
+    if (report.elapsedMs > 0) {
+        report.mazesPerSecond = jobCount / (report.elapsedMs / 1000);
+    }
+    return report;
+}
+
+// Print the throughput of the whole batch, and the mean time spent generating and solving each maze
+void bt::printSummary(const batchReport& report, std::ostream& out) {
+    double generateMs = 0, solveMs = 0;
+    int found = 0;
+    for (const auto& job : report.jobs) {
+        generateMs += job.generateMs;
+        solveMs += job.solveMs;
+        found += job.found;
+    }
+    const int jobCount = std::max<int>(report.jobs.size(), 1);
+    out << "Batch of " << report.jobs.size() << ' ' << report.rows << 'x' << report.cols << " mazes on "
+        << report.threadCount << " threads: " << report.elapsedMs << " ms, " << report.mazesPerSecond
+        << " mazes/s\n"
+        << "  solved " << found << '/' << report.jobs.size() << ", mean generate " << generateMs / jobCount
+        << " ms, mean solve " << solveMs / jobCount << " ms\n";
+}
+
+// Write one line of comma separated values per job, after a header line
+void bt::writeResults(const batchReport& report, std::ostream& out) {
+    out << "job,seed,worker,found,path_length,cells_visited,generate_ms,solve_ms\n";
+    for (std::size_t i = 0; i < report.jobs.size(); i++) {
+        const auto& job = report.jobs[i];
+        out << i << ',' << job.seed << ',' << job.worker << ',' << job.found << ',' << job.pathLength << ','
+            << job.cellsVisited << ',' << job.generateMs << ',' << job.solveMs << '\n';
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <ostream>
+#include <vector>
+
+namespace bt {
+
+// The outcome of one (generate, solve) job
+struct jobResult {
+    // The seed the job's maze was generated from. Generating with the same seed gives the same maze.
+    unsigned seed;
+    // The index of the worker thread which ran the job
+    int worker;
+    bool found;
+    // The number of cells on the solution path, including both ends
+    long long pathLength;
+    // How many cells the solver visited before finding the path
+    int cellsVisited;
+    double generateMs;
+    double solveMs;
+};
+
+// The outcome of a whole batch
+struct batchReport {
+    int rows;
+    int cols;
+    int threadCount;
+    // One result per job, in job order
+    std::vector<jobResult> jobs;
+    double elapsedMs;
+    double mazesPerSecond;
+};
+
+batchReport run(const int jobCount, const int rows, const int cols, int threadCount, const unsigned baseSeed);
+void printSummary(const batchReport& report, std::ostream& out);
+void writeResults(const batchReport& report, std::ostream& out);
+
+}  // namespace bt
+
+#endif /* BATCH_H */
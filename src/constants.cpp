@@ -14,6 +14,17 @@ inline constexpr int ROWS = 15;
 inline constexpr int COLS = 15;
 inline constexpr int CELLWIDTH = 40;
 inline constexpr int CELLHEIGHT = 40;
+// The largest window to open. A larger maze is shown through a camera: drag with the mouse or use the arrow keys to
+// pan, scroll to zoom, and press Home to return to the top left corner at full size. Zoomed out until cells are
+// smaller than a pixel, the maze is drawn from an overview, with blocks of cells shaded by how many walls they hold.
+inline constexpr int MAX_WINDOW_WIDTH = 1600;
+inline constexpr int MAX_WINDOW_HEIGHT = 900;
+inline constexpr float MIN_ZOOM = 0.001f;
+inline constexpr float MAX_ZOOM = 8.0f;
+// How far the arrow keys move the camera each frame, in pixels of the window
+inline constexpr int PAN_SPEED = 20;
+// How many threads build the overview of each maze drawn. 0 means one per core.
+inline constexpr int OVERVIEW_THREADS = 0;
 // How many tasks are allowed to be queued by recursive functions.
 // A STACK OVERFLOW can occur at huge values! In my case it occurred at 1320 tasks in queue.
 // Exceeding this limit may affect simulation behavior, resulting for example in incomplete mazes being generated
@@ -22,15 +33,79 @@ inline constexpr int QUEUE_LENGTH_LIMIT = 500;
 // the FPS to use when generating and solving the maze respectively
 inline constexpr int FPS_GENERATING = 15;
 inline constexpr int FPS_SOLVING = 3;
+// Whether the window runs each animation's simulation on a thread of its own, rather than one step per frame. It then
+// draws the latest state FPS_DISPLAY times a second, while generating and solving each take the number of steps a
+// second set below, where 0 means as many as possible. Without a window, every step is drawn, one per frame.
+inline constexpr bool SIMULATION_THREAD = true;
+inline constexpr int FPS_DISPLAY = 60;
+inline constexpr int GENERATING_STEPS_PER_SECOND = FPS_GENERATING;
+inline constexpr int SOLVING_STEPS_PER_SECOND = FPS_SOLVING;
+
+// Choose how many steps animations take per frame: a fixed number, or as many as they need to finish in about
+// FINISH_IN_SECONDS, spending at most STEP_TIME_BUDGET of each frame's time on them. While an animation runs, press =
+// and - to double and halve the steps per frame, and F to switch between the two. On a simulation thread, the steps
+// per frame multiply its steps per second instead.
+enum pacingMode { PACE_STEPS_PER_FRAME, PACE_FINISH_IN_TIME };
+const pacingMode currentPacingMode = PACE_STEPS_PER_FRAME;
+inline constexpr int STEPS_PER_FRAME = 1;
+inline constexpr double FINISH_IN_SECONDS = 10;
+inline constexpr double STEP_TIME_BUDGET = 0.5;
+
+// Whether to show an overlay of how each animation is performing when it starts. Press H to show or hide it while one
+// runs. Its times are summarized over the last HUD_SAMPLES frames.
+const bool SHOW_HUD = false;
+inline constexpr int HUD_SAMPLES = 120;
+
+// Choose whether to generate and solve one maze in a window, or to generate and solve many mazes without one. Batch
+// mode prints the throughput, and writes the result of every job to BATCH_RESULTS_PATH.
+enum runMode { INTERACTIVE, BATCH };
+const runMode currentRunMode = INTERACTIVE;
+// The number of mazes to generate and solve in batch mode, and the number of threads to share them between.
+// 0 threads means one per core.
+inline constexpr int BATCH_JOBS = 10000;
+inline constexpr int BATCH_THREADS = 0;
+const char* const BATCH_RESULTS_PATH = "batch_results.csv";
+
+// Choose whether to draw into a window, or into memory, e.g. on a server with no display. Headless frames are drawn as
+// fast as possible. Every HEADLESS_FRAME_INTERVAL'th frame, and the last frame of each animation, is written to
+// HEADLESS_FRAME_PATH, after formatting the frame's number into it. Its extension picks the image format.
+enum renderBackend { WINDOW_BACKEND, HEADLESS_BACKEND };
+const renderBackend currentRenderBackend = WINDOW_BACKEND;
+inline constexpr int HEADLESS_FRAME_INTERVAL = 1;
+const char* const HEADLESS_FRAME_PATH = "frame_%06i.png";
+// If set, the frames are streamed into one video per animation instead, written to HEADLESS_VIDEO_PATH after formatting
+// the animation's number into it, e.g. "animation_%03i.gif". Its extension picks the format: GIF for ".gif", and Y4M
+// otherwise. A GIF frame only holds the cells the frame changed; a Y4M frame is always whole.
+const char* const HEADLESS_VIDEO_PATH = "";
+inline constexpr int VIDEO_FPS = 30;
+// If set, the generated maze's walls are also written to this path as an SVG image, with each straight run of walls
+// drawn as one line
+const char* const SVG_EXPORT_PATH = "";
 
 // Choose one of the available algorithms to generate the maze
 enum generatorAlgorithm { RECURSIVE_BACKTRACKING, SILENTLY_GENERATE, ELLERS };
 const generatorAlgorithm currentGenerator = RECURSIVE_BACKTRACKING;
 
 // Choose one of the available algorithms to solve the maze
-enum solverAlgorithm { NAIVE_RECURSIVE, WEIGHTED_RECURSIVE, SKIP_SOLVING };
+enum solverAlgorithm {
+    NAIVE_RECURSIVE,
+    WEIGHTED_RECURSIVE,
+    DEPTH_FIRST,
+    A_STAR,
+    DEAD_END_FILLING,
+    WALL_FOLLOWER,
+    DISTANCE_FIELD,
+    SKIP_SOLVING
+};
 const solverAlgorithm currentSolver = NAIVE_RECURSIVE;
 
+// How many threads the dead-end filling solver splits each round of filling between
+inline constexpr int DEAD_END_FILLER_THREADS = 1;
+
+// Which hand the wall follower keeps on the wall, or whether it uses the Pledge algorithm
+enum wallFollowerRule { LEFT_HAND, RIGHT_HAND, PLEDGE };
+const wallFollowerRule currentWallFollowerRule = LEFT_HAND;
+
 // Set the start and end points for the solving algorithm. These values should be 0 indexed
 const utils::XY solverStart = {0, 0};
 const utils::XY solverEnd = {ROWS - 1, COLS - 1};
@@ -44,11 +119,21 @@ const Color mazeEndpointColor = LIGHTGRAY;
 const Color cellFocusColor = PURPLE;
 // The color to use for the maze walls
 const Color wallColor = BLACK;
+// The color the overview tints cells on the solution with. Visited cells are tinted with cellFocusColor.
+const Color overviewSolutionColor = DARKGREEN;
+
+// Choose how much is logged, and about which parts of the program. Messages less severe than the level, or outside of
+// the categories, are compiled out. LEVEL_NONE turns logging off entirely.
+enum logLevel { LEVEL_TRACE, LEVEL_DEBUG, LEVEL_INFO, LEVEL_WARNING, LEVEL_NONE };
+enum logCategory { LOG_GENERATOR = 1, LOG_SOLVER = 2, LOG_RENDER = 4 };
+const logLevel currentLogLevel = LEVEL_INFO;
+inline constexpr int LOGGED_CATEGORIES = LOG_GENERATOR | LOG_SOLVER | LOG_RENDER;
 
 //------------------------------------------------------------------------------
 // Algorithm related constants. Don't edit these.
 //------------------------------------------------------------------------------
 inline constexpr int NORTH = 1, SOUTH = 2, EAST = 4, WEST = 8;
+inline constexpr int DIRECTIONS[4] = {NORTH, SOUTH, EAST, WEST};
 
 // The difference in x for each direction
 inline std::unordered_map<int, int> DX = {{NORTH, 0}, {SOUTH, 0}, {EAST, 1}, {WEST, -1}};
@@ -6,9 +6,16 @@
 #include <iostream>
 #include <memory>
 #include <random>
+#include <sstream>
 #include "../../lib/raylib.h"
 #include "../constants.cpp"
+#include "../hud.h"
+#include "../log.h"
+#include "../overview.h"
+#include "../pacing.h"
+#include "../render.h"
 #include "../utils.h"
+#include "../viewer.h"
 #include "unordered_map"
 #include "unordered_set"
 #include "vector"
@@ -31,6 +38,8 @@ static std::unordered_map<int, std::unordered_set<int>> g_mapGroupToIdx;
 // 0 indexed. This is the row we're currently updating
 static int g_currentRow = 0;
 static int g_maxGroupNrSeen = 0;
+// The overview drawn when zoomed out
+static ov::pyramid g_overview = {};
 
 // Holds tasks required for simulation, in a queue, to be called later
 // std::deque<std::packaged_task<bool()>> el::taskDeque;
@@ -46,7 +55,7 @@ void el::simulationTick() {
         std::fill_n(g_idxToDirection, constants::ROWS * constants::COLS, -1);
 
         srand(time(NULL));
-        for (int i = 0; i < constants::ROWS; i++) {
+        for (int i = 0; i < constants::COLS; i++) {
             el::insertGroupMapping(i, i);
             g_maxGroupNrSeen = i;
         }
@@ -66,13 +75,16 @@ void el::simulationTick() {
             conditionallyMergeGroups(rowBaseIdx, rowBaseIdx + c);
         }
         g_currentRow += 1;
-        // DEBUG code: print the contents of vecIdxToGroup
-        // for (int i = 0; i < constants::ROWS; i++) {
-        //     for (int j = 0; j < constants::COLS; j++) {
-        //         std::cout << vecIdxToGroup.at(i * constants::COLS + j) << ' ';
-        //     }
-        //     std::cout << '\n';
-        // }
+        // DEBUG code: print the group of every cell
+        if constexpr (lg::enabled(LEVEL_TRACE, LOG_GENERATOR)) {
+            for (int i = 0; i < constants::ROWS; i++) {
+                std::ostringstream row;
+                for (int j = 0; j < constants::COLS; j++) {
+                    row << g_mapIdxToGroup[i * constants::COLS + j] << ' ';
+                }
+                MAZE_LOG(LEVEL_TRACE, LOG_GENERATOR, row.str());
+            }
+        }
         // auto grid = el::exportCardinalMaze();
         // InitWindow(constants::COLS * constants::CELLWIDTH, constants::ROWS * constants::CELLHEIGHT,
         //            "Eller's Algorithm");
@@ -116,7 +128,7 @@ void el::simulationTick() {
             }
             if (rand() % 10 == 1) {
                 // too great a chance of connecting downwards results in boring maze
-                connectingDownwards.insert(cellIndices.at(idx));
+                connectingDownwards.insert(idx);
             }
         }
     }
@@ -146,16 +158,30 @@ void el::simulationTick() {
     g_currentRow += 1;
 }
 
+// Show the groups of each row's cells as the rows are joined, taking as many rows per frame as pacing asks for
 void el::_nonWasmFuncToDisplayMazeBuildSteps(const gridType& grid) {
-    SetTargetFPS(constants::FPS_GENERATING);
-    while (!WindowShouldClose())  // Detect window close button or ESC key
-    {
-        BeginDrawing();
-        // el::simulationTick();
+    pc::begin(constants::ROWS, constants::FPS_GENERATING);
+    rd::setTargetFPS(constants::FPS_GENERATING);
+    bool done = false;
+    while (!rd::shouldClose(done)) {
+        vw::update();
+        pc::update();
+        hd::update();
+        rd::beginFrame();
         el::_simulationDraw(grid);
-        EndDrawing();
+        done = g_currentRow >= constants::ROWS;
+        if (!done) {
+            pc::advance([]() {
+                el::simulationTick();
+                return g_currentRow < constants::ROWS;
+            });
+        }
+        // Each row's cells have been given their groups once it's done
+        hd::draw((long long)std::min(g_currentRow, constants::ROWS) * constants::COLS,
+                 (long long)constants::ROWS * constants::COLS);
+        rd::endFrame();
     }
-    CloseWindow();
+    rd::close();
 }
 
 void el::insertGroupMapping(const int groupNr, const int idx) {
@@ -212,29 +238,39 @@ void el::generateMazeInstantlyNoDisplay() {
 }
 
 void el::_simulationDraw(const gridType& grid) { 
-    // Helps draw grid state in GUI. Expects an existing window.
-    ClearBackground(RAYWHITE);
-    for (int y = 0; y < grid.size(); y++) {
-        for (int x = 0; x < grid.at(0).size(); x++) {
+    // Helps draw grid state in GUI. Expects an open window or canvas.
+    rd::clear(RAYWHITE);
+    // Zoomed out until cells are smaller than a pixel, draw the overview instead. The grid doesn't change while it's
+    // displayed, so the overview is only built once.
+    const int detailLevel = vw::detailLevel();
+    if (detailLevel > 0) {
+        if (g_overview.cells.empty()) {
+            g_overview = ov::build(grid, OVERVIEW_THREADS);
+        }
+        ov::draw(g_overview, detailLevel, RAYWHITE, BLACK, cellFocusColor, overviewSolutionColor);
+        return;
+    }
+    const vw::cellRange visible = vw::visibleCells(grid.size(), grid.at(0).size());
+    for (int y = visible.minY; y < visible.maxY; y++) {
+        for (int x = visible.minX; x < visible.maxX; x++) {
             int val = grid.at(y).at(x);
 
             // DEBUG code
-            if ((y * constants::COLS + x) > std::size(g_mapIdxToGroup) - 1) {
+            if ((y * constants::COLS + x) > (int)std::size(g_mapIdxToGroup) - 1) {
                 continue;
             }
 
-            std::cout << x << ',' << y << '\n';
             // Draw the group number
             // TODO: stop this from out of range core dumping
-            // std::cout<<x<<','<<y<<'\n';
             // TODO: resolve why 0 size
-            std::cout << std::size(g_mapIdxToGroup) << '\n';
+            MAZE_LOG(LEVEL_TRACE, LOG_RENDER,
+                     "drawing " << x << ',' << y << " of " << std::size(g_mapIdxToGroup) << " group mappings");
             int idx = y * constants::COLS + x;
             // if (vecIdxToGroup.size() < idx + 1) {
             //     continue;
             // }
 
-            DrawText(std::to_string(g_mapIdxToGroup[idx]).c_str(), x * CELLWIDTH + 5, y * CELLHEIGHT + 5, 6, BLACK);
+            rd::text(std::to_string(g_mapIdxToGroup[idx]).c_str(), x * CELLWIDTH + 5, y * CELLHEIGHT + 5, 6, BLACK);
 
             bool northBlocked =
                 utils::inBounds(grid, x, y - 1) && (grid.at(y - 1).at(x) & SOUTH) == 0 && (val & NORTH) == 0;
@@ -246,19 +282,19 @@ void el::_simulationDraw(const gridType& grid) {
                 utils::inBounds(grid, x - 1, y) && (grid.at(y).at(x - 1) & EAST) == 0 && (val & WEST) == 0;
 
             if (northBlocked) {
-                DrawLine(x * CELLWIDTH, y * CELLHEIGHT, (x + 1) * CELLWIDTH, y * CELLHEIGHT, BLACK);
+                rd::line(x * CELLWIDTH, y * CELLHEIGHT, (x + 1) * CELLWIDTH, y * CELLHEIGHT, BLACK);
             }
 
             if (southBlocked) {
-                DrawLine(x * CELLWIDTH, (y + 1) * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
+                rd::line(x * CELLWIDTH, (y + 1) * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
             }
 
             if (eastBlocked) {
-                DrawLine((x + 1) * CELLWIDTH, y * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
+                rd::line((x + 1) * CELLWIDTH, y * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
             }
 
             if (westBlocked) {
-                DrawLine(x * CELLWIDTH, y * CELLHEIGHT, x * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
+                rd::line(x * CELLWIDTH, y * CELLHEIGHT, x * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
             }
         }
     }
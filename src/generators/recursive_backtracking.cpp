@@ -2,12 +2,21 @@
 
 #include "recursive_backtracking.h"
 #include <algorithm>
+#include <chrono>
 #include <deque>
+#include <functional>
 #include <future>
 #include <random>
+#include <vector>
 #include "../../lib/raylib.h"
 #include "../constants.cpp"
+#include "../hud.h"
+#include "../pacing.h"
+#include "../render.h"
+#include "../simulation.h"
 #include "../utils.h"
+#include "../viewer.h"
+#include "../wall_layer.h"
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
 #endif
@@ -34,9 +43,82 @@ struct mostRecentGridEdit {
 };
 struct mostRecentGridEdit mrge;
 
+// The number of cells connected to the maze so far
+static long long g_cellsCarved = 0;
+
+// A cell changed by the simulation thread, and its new value
+struct cellChange {
+    XY cell;
+    int value;
+};
+
+// What the status line and the highlighted cells show, as of the simulation thread's last tick
+struct generationStatus {
+    std::size_t taskCount;
+    mostRecentGridEdit edit;
+    long long cellsCarved;
+    // The number of ticks taken so far
+    long long ticks;
+};
+
+// The walls drawn so far, loaded by the first frame drawn. Only the cells of the most recent edit change between one
+// frame and the next, so only their walls are redrawn.
+static wl::wallLayer g_walls = {};
+static bool g_wallsLoaded = false;
+// The cells which may look different from the last frame drawn: the ones highlighted in it, and the ones edited since
+static std::vector<XY> g_changedCells = {};
+
+// The number of ticks it takes to generate a maze in the grid: one per cell connected to the first
+static long long expectedTicks(const gridType& grid) {
+    return (long long)grid.size() * grid.at(0).size() - 1;
+}
+
+// Draw the grid, with the number of queued tasks and the cells of the given edit highlighted. Expects an open window
+// or canvas.
+static void drawFrame(const gridType& grid, const std::size_t taskCount, const mostRecentGridEdit& edit) {
+    // Only the cells which changed since the last frame, with their walls, are drawn again. Zoomed out, the overview
+    // draws several cells to a pixel, so the frame is drawn whole.
+    g_changedCells.push_back({edit.x0, edit.y0});
+    g_changedCells.push_back({edit.x1, edit.y1});
+    for (const XY& cell : g_changedCells) {
+        if (vw::detailLevel() == 0 && cell.x >= 0 && cell.y >= 0 && inBounds(grid, cell)) {
+            rd::markDirty(cell.x * CELLWIDTH, cell.y * CELLHEIGHT, CELLWIDTH + 1, CELLHEIGHT + 1);
+        }
+    }
+    g_changedCells = {{edit.x0, edit.y0}, {edit.x1, edit.y1}};
+
+    rd::clear(RAYWHITE);
+    rd::screenText(TextFormat("Tasks: %01i", (int)taskCount), 10, 10, 10, MAROON);
+
+    // Draw the walls between cells
+    if (!g_wallsLoaded) {
+        g_walls = wl::load(grid, BLACK);
+        g_wallsLoaded = true;
+    }
+    wl::draw(g_walls);
+
+    // Draw rectangles to help the user identify the most recent cells to have changed. They're drawn over the walls
+    // on their north and west sides.
+    if (edit.x0 >= 0 && inBounds(grid, edit.x0, edit.y0))
+        rd::rectangle(edit.x0 * CELLWIDTH, edit.y0 * CELLHEIGHT, CELLWIDTH, CELLHEIGHT, PINK);
+    if (edit.x1 >= 0 && inBounds(grid, edit.x1, edit.y1))
+        rd::rectangle(edit.x1 * CELLWIDTH, edit.y1 * CELLHEIGHT, CELLWIDTH, CELLHEIGHT, PINK);
+}
+
+// Redraw the walls around the cells changed by the last tick
+static void redrawEditedWalls() {
+    if (g_wallsLoaded) {
+        wl::redrawCell(g_walls, {mrge.x0, mrge.y0});
+        wl::redrawCell(g_walls, {mrge.x1, mrge.y1});
+    }
+    g_changedCells.push_back({mrge.x0, mrge.y0});
+    g_changedCells.push_back({mrge.x1, mrge.y1});
+}
+
 // Progress the state of the maze generation by one tick. If the tick does not effect a visual change,
 // then execute subsequent ticks, until the state of the maze changes as a result.
 void rb::simulationTick(utils::gridType* grid) {
+    bumpGridGeneration();
     if (_firstSimulationTick) {
         _firstSimulationTick = false;
         XY start = {0, 0};
@@ -61,17 +143,76 @@ void rb::simulationTick(utils::gridType* grid) {
 void rb::_wasmFuncToDisplayMazeBuildSteps(void* arg) {
     gridType* grid_ptr = static_cast<gridType*>(arg);
 
-    BeginDrawing();
+    vw::update();
+    rd::beginFrame();
     rb::_simulationDraw(grid_ptr);
     rb::simulationTick(grid_ptr);
-    EndDrawing();
+    redrawEditedWalls();
+    rd::endFrame();
     if (taskDeque.empty()) {
         // repeat one last time, to ensure the final state (e.g. task count) is displayed, then stop
-        BeginDrawing();
+        rd::beginFrame();
         rb::simulationTick(grid_ptr);
+        redrawEditedWalls();
         rb::_simulationDraw(grid_ptr);
-        EndDrawing();
+        rd::endFrame();
+    }
+}
+
+// Generate the maze on a thread of its own, while this one draws a copy of the grid, kept up to date with the cells
+// the simulation thread changes. Neither waits for the other, so the maze is generated at GENERATING_STEPS_PER_SECOND,
+// or as fast as pacing asks for, however fast frames are drawn.
+static void displayFromSimulationThread(gridType* grid) {
+    pc::begin(expectedTicks(*grid), FPS_DISPLAY);
+    gridType shown = *grid;
+    sm::doubleBuffer<cellChange, generationStatus> updates;
+    sm::update<cellChange, generationStatus> latest;
+    sm::worker simulation;
+    long long ticks = 0;
+    simulation.start(
+        [&]() {
+            rb::simulationTick(grid);
+            for (const XY& cell : {XY{mrge.x0, mrge.y0}, XY{mrge.x1, mrge.y1}}) {
+                if (cell.x >= 0 && cell.y >= 0 && inBounds(*grid, cell)) {
+                    updates.record({cell, grid->at(cell.y).at(cell.x)});
+                }
+            }
+            updates.back.status = {taskDeque.size(), mrge, g_cellsCarved, ++ticks};
+            return !taskDeque.empty();
+        },
+        [&]() { updates.publish(); }, pc::stepsPerSecond(GENERATING_STEPS_PER_SECOND));
+
+    rd::setTargetFPS(FPS_DISPLAY);
+    // The ticks which the frames drawn so far have shown
+    long long ticksShown = 0;
+    bool done = false;
+    while (!rd::shouldClose(done)) {
+        vw::update();
+        pc::update();
+        hd::update();
+        simulation.setRate(pc::stepsPerSecond(GENERATING_STEPS_PER_SECOND));
+        // Once the simulation has finished, whatever it published last is taken below, so this frame shows the
+        // finished maze
+        done = simulation.finished();
+        const auto applyStart = std::chrono::steady_clock::now();
+        if (updates.take(latest)) {
+            for (const cellChange& change : latest.changes) {
+                shown.at(change.cell.y).at(change.cell.x) = change.value;
+                if (g_wallsLoaded) {
+                    wl::redrawCell(g_walls, change.cell);
+                }
+                g_changedCells.push_back(change.cell);
+            }
+        }
+        // A tick changes up to two cells, so count the ticks published since the last frame rather than the changes
+        hd::recordSimulation(applyStart, latest.status.ticks - ticksShown);
+        ticksShown = latest.status.ticks;
+        rd::beginFrame();
+        drawFrame(shown, latest.status.taskCount, latest.status.edit);
+        hd::draw(latest.status.cellsCarved, (long long)shown.size() * shown.at(0).size());
+        rd::endFrame();
     }
+    simulation.stop();
 }
 
 void rb::_nonWasmFuncToDisplayMazeBuildSteps(void* arg) {
@@ -79,15 +220,35 @@ void rb::_nonWasmFuncToDisplayMazeBuildSteps(void* arg) {
     // And we need void* because that's what emscripten's set main loop function expects
     gridType* grid_ptr = static_cast<gridType*>(arg);
 
-    SetTargetFPS(FPS_GENERATING);
-    while (!WindowShouldClose())  // Detect window close button or ESC key
-    {
-        BeginDrawing();
-        rb::_simulationDraw(grid_ptr);
-        rb::simulationTick(grid_ptr);
-        EndDrawing();
+    if (SIMULATION_THREAD && !rd::isHeadless()) {
+        displayFromSimulationThread(grid_ptr);
+    } else {
+        pc::begin(expectedTicks(*grid_ptr), FPS_GENERATING);
+        rd::setTargetFPS(FPS_GENERATING);
+        bool done = false;
+        while (!rd::shouldClose(done)) {
+            vw::update();
+            pc::update();
+            hd::update();
+            rd::beginFrame();
+            rb::_simulationDraw(grid_ptr);
+            // Once the queue has emptied, the tick changes nothing, so this frame shows the finished maze
+            done = !_firstSimulationTick && taskDeque.empty();
+            pc::advance([&]() {
+                rb::simulationTick(grid_ptr);
+                redrawEditedWalls();
+                return !taskDeque.empty();
+            });
+            hd::draw(g_cellsCarved, (long long)grid_ptr->size() * grid_ptr->at(0).size());
+            rd::endFrame();
+        }
+    }
+    if (g_wallsLoaded) {
+        wl::unload(g_walls);
+        g_wallsLoaded = false;
     }
-    CloseWindow();
+    g_changedCells.clear();
+    rd::close();
 }
 
 // Generates the maze instantly, with no animation
@@ -97,27 +258,56 @@ void rb::generateMazeInstantlyNoDisplay(utils::gridType* grid) {
     } while (!taskDeque.empty());
 }
 
-// Helps draw grid state in GUI. Expects an existing window.
-void rb::_simulationDraw(utils::gridType* grid) {
-    ClearBackground(RAYWHITE);
-    DrawText(TextFormat("Tasks: %01i", taskDeque.size()), 10, 10, 10, MAROON);
-    for (int y = 0; y < grid->size(); y++) {
-        for (int x = 0; x < grid->at(0).size(); x++) {
-            int val = grid->at(y).at(x);
-
-            // Draw the walls between cells
-            if (val != SOUTH && !(y < grid->size() - 1 && grid->at(y + DY[SOUTH])[x] == NORTH))
-                DrawLine(x * CELLWIDTH, (y + 1) * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
-            if (val != EAST && !(x < grid->at(0).size() - 1 && grid->at(y)[x + DX[EAST]] == WEST))
-                DrawLine((x + 1) * CELLWIDTH, y * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, BLACK);
-
-            // Draw rectangles to help the user identify the most recent cells to have changed
-            if (mrge.x0 == x && mrge.y0 == y)
-                DrawRectangle(mrge.x0 * CELLWIDTH, mrge.y0 * CELLHEIGHT, CELLWIDTH, CELLHEIGHT, PINK);
-            if (mrge.x1 == x && mrge.y1 == y)
-                DrawRectangle(mrge.x1 * CELLWIDTH, mrge.y1 * CELLHEIGHT, CELLWIDTH, CELLHEIGHT, PINK);
+// Generates the maze instantly, with no animation, using an explicit stack instead of the task queue. Unlike
+// generateMazeInstantlyNoDisplay, this isn't bound by QUEUE_LENGTH_LIMIT and touches no global state, so it can
+// generate mazes of any size, and can be called repeatedly and from several threads at once. Expects an empty grid.
+void rb::generateMazeIteratively(utils::gridType* grid, std::mt19937& rng) {
+    carveBuffers buffers = {};
+    generateMazeIteratively(grid, rng, buffers);
+}
+
+void rb::generateMazeIteratively(utils::gridType* grid, std::mt19937& rng, carveBuffers& buffers) {
+    const int cols = grid->at(0).size();
+    auto& visited = buffers.visited;
+    auto& stack = buffers.stack;
+    auto& directions = buffers.directions;
+    visited.assign(grid->size() * cols, false);
+    stack.assign(1, {0, 0});
+    visited[0] = true;
+
+    while (!stack.empty()) {
+        const XY current = stack.back();
+
+        // Pick a random unvisited neighbor to carve a passage to. Once there are none, backtrack.
+        directions.clear();
+        for (const int direction : DIRECTIONS) {
+            const XY neighbor = neighborOf(current, direction);
+            if (neighbor.x >= 0 && neighbor.y >= 0 && inBounds(*grid, neighbor) &&
+                !visited[neighbor.y * cols + neighbor.x]) {
+                directions.push_back(direction);
+            }
+        }
+        if (directions.empty()) {
+            stack.pop_back();
+            continue;
         }
+
+        const int direction = directions[std::uniform_int_distribution<int>(0, directions.size() - 1)(rng)];
+        const XY neighbor = neighborOf(current, direction);
+        // Like _carvePassagesHelper, don't overwrite existing connections
+        if (grid->at(current.y).at(current.x) == 0) {
+            grid->at(current.y).at(current.x) = direction;
+        }
+        grid->at(neighbor.y).at(neighbor.x) = oppositeOf(direction);
+        visited[neighbor.y * cols + neighbor.x] = true;
+        stack.push_back(neighbor);
     }
+    bumpGridGeneration();
+}
+
+// Helps draw grid state in GUI. Expects an open window or canvas.
+void rb::_simulationDraw(utils::gridType* grid) {
+    drawFrame(*grid, taskDeque.size(), mrge);
 }
 
 //------------------------------------------------------------------------------
@@ -170,8 +360,10 @@ bool rb::_carvePassagesHelper(const XY& start, const XY& target, const int direc
         grid->at(start.y).at(start.x) = direction;
         mrge.x0 = start.x;
         mrge.y0 = start.y;
+        g_cellsCarved++;
     }
     grid->at(target.y).at(target.x) = OPPOSITE[direction];
+    g_cellsCarved++;
     mrge.x1 = target.x;
     mrge.y1 = target.y;
 
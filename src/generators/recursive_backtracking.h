@@ -1,12 +1,23 @@
 #ifndef RECURSIVE_BACKTRACKING_H
 #define RECURSIVE_BACKTRACKING_H
 
+#include <random>
+#include <vector>
 #include "../utils.h"
 using namespace utils;
 
 namespace rb {
 
+// Working memory for generateMazeIteratively. Passing the same buffers to repeated calls saves reallocating them.
+struct carveBuffers {
+    std::vector<bool> visited;
+    std::vector<XY> stack;
+    std::vector<int> directions;
+};
+
 void generateMazeInstantlyNoDisplay(gridType* grid);
+void generateMazeIteratively(gridType* grid, std::mt19937& rng);
+void generateMazeIteratively(gridType* grid, std::mt19937& rng, carveBuffers& buffers);
 void simulationTick(gridType* grid);
 
 void _wasmFuncToDisplayMazeBuildSteps(void* arg);
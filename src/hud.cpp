@@ -0,0 +1,146 @@
+// Measure how each frame of an animation spends its time, and draw the measurements over it. Samples are kept in rings
+// of a fixed size, so the overlay allocates nothing while it's shown, and does nothing at all while it's hidden.
+
+#include "hud.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "../lib/raylib.h"
+#include "constants.cpp"
+#include "pacing.h"
+#include "render.h"
+#include "utils.h"
+
+using namespace constants;
+
+typedef std::chrono::steady_clock hudClock;
+
+static const Color HUD_COLOR = MAROON;
+static const int HUD_FONT_SIZE = 10;
+// Where the overlay's first line is drawn, below the animation's status line, and the distance between its lines
+static const int HUD_LEFT = 5;
+static const int HUD_TOP = 25;
+static const int HUD_LINE_HEIGHT = 12;
+
+// The last HUD_SAMPLES values of one measurement, oldest overwritten first
+struct rollingSamples {
+    std::array<double, HUD_SAMPLES> values = {};
+    int count = 0;
+    int next = 0;
+};
+
+struct sampleSummary {
+    double min;
+    double mean;
+    double p99;
+};
+
+static bool g_shown = SHOW_HUD;
+// When the frame being drawn started, or the epoch if the frame before it wasn't measured
+static hudClock::time_point g_frameStart = {};
+static double g_frameSimulationMs = 0;
+static long long g_frameSteps = 0;
+static rollingSamples g_drawMs = {};
+static rollingSamples g_simulationMs = {};
+// The time from the start of each frame to the start of the next, and the steps taken in it
+static rollingSamples g_frameMs = {};
+static rollingSamples g_stepCounts = {};
+
+static double millisecondsBetween(const hudClock::time_point& begin, const hudClock::time_point& end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+static void add(rollingSamples& samples, const double value) {
+    samples.values[samples.next] = value;
+    samples.next = (samples.next + 1) % HUD_SAMPLES;
+    samples.count = std::min(samples.count + 1, HUD_SAMPLES);
+}
+
+static double sum(const rollingSamples& samples) {
+    double total = 0;
+    for (int i = 0; i < samples.count; i++) {
+        total += samples.values[i];
+    }
+    return total;
+}
+
+static sampleSummary summarize(const rollingSamples& samples) {
+    if (samples.count == 0) {
+        return {0, 0, 0};
+    }
+    std::array<double, HUD_SAMPLES> sorted = samples.values;
+    std::sort(sorted.begin(), sorted.begin() + samples.count);
+    const int p99Idx = std::max(0, (int)std::ceil(samples.count * 0.99) - 1);
+    return {sorted[0], sum(samples) / samples.count, sorted[p99Idx]};
+}
+
+// Show or hide the overlay when H is pressed, and start timing the frame if it's shown. Call at the start of every
+// frame, before anything is simulated or drawn.
+void hd::update() {
+    if (!rd::isHeadless() && IsKeyPressed(KEY_H)) {
+        g_shown = !g_shown;
+        // Frames from before it was hidden would skew the measurements of those after it's shown again
+        g_drawMs = {};
+        g_simulationMs = {};
+        g_frameMs = {};
+        g_stepCounts = {};
+        g_frameStart = {};
+    }
+    if (!g_shown) {
+        return;
+    }
+    const auto now = hudClock::now();
+    if (g_frameStart != hudClock::time_point{}) {
+        add(g_frameMs, millisecondsBetween(g_frameStart, now));
+        add(g_stepCounts, g_frameSteps);
+    }
+    g_frameStart = now;
+    g_frameSimulationMs = 0;
+    g_frameSteps = 0;
+}
+
+bool hd::shown() {
+    return g_shown;
+}
+
+// Count the time since start, and the given number of steps, as this frame's simulation. On a simulation thread, that's
+// the time spent applying the steps it published.
+void hd::recordSimulation(const std::chrono::steady_clock::time_point& start, const long long steps) {
+    if (!g_shown) {
+        return;
+    }
+    g_frameSimulationMs += millisecondsBetween(start, hudClock::now());
+    g_frameSteps += steps;
+}
+
+// Draw the overlay, counting the time since update, less the simulation's, as this frame's drawing. visited is the
+// number of the maze's cellCount cells which the animation has reached so far.
+void hd::draw(const long long visited, const long long cellCount) {
+    if (!g_shown) {
+        return;
+    }
+    const double frameMs = millisecondsBetween(g_frameStart, hudClock::now());
+    add(g_drawMs, std::max(0.0, frameMs - g_frameSimulationMs));
+    add(g_simulationMs, g_frameSimulationMs);
+    const sampleSummary drawMs = summarize(g_drawMs);
+    const sampleSummary simulationMs = summarize(g_simulationMs);
+    const double measuredMs = sum(g_frameMs);
+    const double stepsPerSecond = measuredMs > 0 ? sum(g_stepCounts) * 1000 / measuredMs : 0;
+
+    int y = HUD_TOP;
+    auto line = [&y](const char* message) {
+        rd::screenText(message, HUD_LEFT, y, HUD_FONT_SIZE, HUD_COLOR);
+        y += HUD_LINE_HEIGHT;
+    };
+    line(TextFormat("Draw: %.2f / %.2f / %.2f ms (min / mean / p99)", drawMs.min, drawMs.mean, drawMs.p99));
+    line(TextFormat("Sim: %.2f / %.2f / %.2f ms", simulationMs.min, simulationMs.mean, simulationMs.p99));
+    line(TextFormat("Steps/s: %.0f", stepsPerSecond));
+    line(TextFormat("Visited: %lld of %lld (%.1f%%)", visited, cellCount,
+                    cellCount > 0 ? 100.0 * visited / cellCount : 0.0));
+    line(TextFormat("Memory: %.1f MB", utils::residentMemoryKb() / 1024.0));
+    if (pc::finishingInTime()) {
+        line(TextFormat("Pace: finishing in %.0f s", FINISH_IN_SECONDS));
+    } else {
+        line(TextFormat("Pace: %i steps per frame", pc::stepsPerFrame()));
+    }
+}
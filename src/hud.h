@@ -0,0 +1,23 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <chrono>
+
+namespace hd {
+
+// An overlay of how the program is performing, drawn below an animation's status line: how long each frame spends
+// drawing and simulating, how many steps a second the simulation takes, how much of the maze it has explored, and how
+// much memory the process holds. Times are the minimum, mean and 99th percentile over the last HUD_SAMPLES frames.
+// Press H to show or hide it. While it's hidden, nothing is measured, so it costs nothing.
+//
+// Each animation's frame loop calls update at the start of every frame, recordSimulation after taking its steps, and
+// draw once the frame has been drawn.
+
+void update();
+bool shown();
+void recordSimulation(const std::chrono::steady_clock::time_point& start, const long long steps);
+void draw(const long long visited, const long long cellCount);
+
+}  // namespace hd
+
+#endif /* HUD_H */
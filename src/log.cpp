@@ -0,0 +1,52 @@
+// Buffer log messages per thread, so that logging doesn't write to the console, or take a lock, on every message.
+
+#include "log.h"
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+// Once a thread has buffered this many bytes, they're written out
+static const std::streamoff FLUSH_THRESHOLD = 64 * 1024;
+
+// Serializes writes to stdout, so that the buffers of different threads don't interleave
+static std::mutex g_outputMutex;
+
+// A thread's buffered messages. Anything left in it is written out when the thread exits.
+struct threadBuffer {
+    std::ostringstream messages;
+
+    void writeOut() {
+        if (messages.tellp() <= 0) {
+            return;
+        }
+        {
+            const std::lock_guard<std::mutex> lock(g_outputMutex);
+            std::cout << messages.view() << std::flush;
+        }
+        messages.str({});
+    }
+
+    ~threadBuffer() { writeOut(); }
+};
+
+static threadBuffer& localBuffer() {
+    thread_local threadBuffer buffer;
+    return buffer;
+}
+
+// Write out the messages buffered by the calling thread
+void lg::flush() {
+    localBuffer().writeOut();
+}
+
+std::ostringstream& lg::_buffer() {
+    return localBuffer().messages;
+}
+
+// Write out the calling thread's messages once they fill the buffer, or straight away after a warning, so that it
+// appears in order with whatever else is written to the console
+void lg::_messageEnded(const constants::logLevel level) {
+    if (level >= constants::LEVEL_WARNING || localBuffer().messages.tellp() >= FLUSH_THRESHOLD) {
+        lg::flush();
+    }
+}
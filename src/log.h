@@ -0,0 +1,35 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <sstream>
+#include "constants.cpp"
+
+// Log a message, e.g. MAZE_LOG(LEVEL_DEBUG, LOG_SOLVER, "visited " << x << ',' << y);
+// The message is only built if its level and category are enabled in constants.cpp. Otherwise the whole statement is
+// discarded at compile time, so logging in a hot loop costs nothing when it's turned off.
+// Messages are buffered per thread, and written to stdout when the buffer fills, on lg::flush, or when the thread exits.
+// Every frame, and the end of every animation, flushes the drawing thread's buffer. Warnings are written at once.
+#define MAZE_LOG(level, category, message)                                     \
+    do {                                                                       \
+        if constexpr (lg::enabled(constants::level, constants::category)) {    \
+            lg::_buffer() << message << '\n';                                  \
+            lg::_messageEnded(constants::level);                               \
+        }                                                                      \
+    } while (0)
+
+namespace lg {
+
+// Whether messages of the given level and category are logged
+constexpr bool enabled(const constants::logLevel level, const constants::logCategory category) {
+    return constants::currentLogLevel != constants::LEVEL_NONE && level >= constants::currentLogLevel &&
+           (constants::LOGGED_CATEGORIES & category) != 0;
+}
+
+void flush();
+
+std::ostringstream& _buffer();
+void _messageEnded(const constants::logLevel level);
+
+}  // namespace lg
+
+#endif /* LOG_H */
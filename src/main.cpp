@@ -7,14 +7,24 @@ How to use:
     - Execute
 */
 #include <ctime>
+#include <fstream>
 #include <stdexcept>
 #include "../lib/raylib.h"
+#include "batch.h"
+#include "log.h"
 #include "constants.cpp"
 #include "generators/ellers.h"
 #include "generators/recursive_backtracking.h"
+#include "render.h"
+#include "solvers/a_star_solver.h"
+#include "solvers/dead_end_filler.h"
+#include "solvers/depth_first_solver.h"
+#include "solvers/distance_field.h"
 #include "solvers/naive_recursive_solver.h"
+#include "solvers/wall_follower.h"
 #include "solvers/weighted_proximity_recursive.h"
 #include "utils.h"
+#include "wall_geometry.h"
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
 #endif
@@ -24,6 +34,14 @@ using namespace constants;
 
 int main() {
     srand(time(NULL));
+    if (currentRunMode == BATCH) {
+        const auto report = bt::run(BATCH_JOBS, ROWS, COLS, BATCH_THREADS, time(NULL));
+        std::ofstream results(BATCH_RESULTS_PATH);
+        bt::writeResults(report, results);
+        bt::printSummary(report, std::cout);
+        return 0;
+    }
+
     // Create an empty data structure to hold the future maze
     gridType grid = createEmptyGrid(ROWS, COLS);
     auto dims = utils::calculateCanvasDimensions();
@@ -37,14 +55,14 @@ int main() {
     switch (currentGenerator) {
         case RECURSIVE_BACKTRACKING: {
             // TODO: get WASM display working. The desktop version is now fine.
-            InitWindow(dims.x, dims.y, "Maze Generator: recursive backtracking");
+            rd::open(dims.x, dims.y, "Maze Generator: recursive backtracking");
             rb::_nonWasmFuncToDisplayMazeBuildSteps(&grid);
             break;
         }
         case ELLERS:
             // el::generateMazeInstantlyNoDisplay();
             // TODO: WIP replace these lines. At the moment, we use them to print the final state of the maze
-            InitWindow(dims.x, dims.y, "Maze Generator: Eller's algorithm");
+            rd::open(dims.x, dims.y, "Maze Generator: Eller's algorithm");
             el::_nonWasmFuncToDisplayMazeBuildSteps(grid);
             std::cout << "Generated maze using Eller's algorithm\n" << std::endl;
             break;
@@ -57,17 +75,49 @@ int main() {
             throw std::invalid_argument("The chosen generator algorithm is not yet implemented");
     };
 
+    lg::flush();
+
+    if (SVG_EXPORT_PATH[0] != '\0') {
+        std::ofstream svg(SVG_EXPORT_PATH);
+        wg::writeSvg(wg::build(grid), svg, CELLWIDTH, CELLHEIGHT, RAYWHITE, wallColor);
+    }
+
     switch (currentSolver) {
         case NAIVE_RECURSIVE:
-            InitWindow(dims.x, dims.y, "Naive Recursive Solver");
+            rd::open(dims.x, dims.y, "Naive Recursive Solver");
             ns::animateSolution(grid);
             break;
 
         case WEIGHTED_RECURSIVE:
-            InitWindow(dims.x, dims.y, "Proximity Weighted Recursive Solver");
+            rd::open(dims.x, dims.y, "Proximity Weighted Recursive Solver");
             ws::animateSolution(grid);
             break;
 
+        case DEPTH_FIRST:
+            rd::open(dims.x, dims.y, "Depth First Solver");
+            ds::animateSolution(grid);
+            break;
+
+        case A_STAR:
+            rd::open(dims.x, dims.y, "A* Solver");
+            as::animateSolution(grid);
+            break;
+
+        case DEAD_END_FILLING:
+            rd::open(dims.x, dims.y, "Dead-end Filling Solver");
+            de::animateSolution(grid);
+            break;
+
+        case WALL_FOLLOWER:
+            rd::open(dims.x, dims.y, "Wall Follower Solver");
+            wf::animateSolution(grid, currentWallFollowerRule);
+            break;
+
+        case DISTANCE_FIELD:
+            rd::open(dims.x, dims.y, "Distance Field Solver");
+            df::animateSolution(grid);
+            break;
+
         case SKIP_SOLVING:
             break;
 
@@ -0,0 +1,80 @@
+// Store mazes on disk, and read them back without loading them into memory.
+// File layout: the 4 byte magic "MAZE", the number of rows and columns as 32 bit integers, then one byte per cell,
+// row after row. Each byte holds the same direction bits as the corresponding gridType value.
+
+#include "maze_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "constants.cpp"
+#include "utils.h"
+
+static const char MAGIC[4] = {'M', 'A', 'Z', 'E'};
+static const std::size_t HEADER_LENGTH = sizeof(MAGIC) + 2 * sizeof(std::int32_t);
+
+// Write the grid to the file at the given path, overwriting it if it exists
+void mf::writeMaze(const gridType& grid, const std::string& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Could not open " + path + " for writing");
+    }
+
+    const std::int32_t rows = grid.size();
+    const std::int32_t cols = grid.at(0).size();
+    file.write(MAGIC, sizeof(MAGIC));
+    file.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    file.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
+
+    std::vector<char> row(cols);
+    for (const auto& gridRow : grid) {
+        for (int x = 0; x < cols; x++) {
+            row[x] = static_cast<char>(gridRow[x]);
+        }
+        file.write(row.data(), cols);
+    }
+}
+
+// Map the maze file at the given path into memory. Call unmapMaze once done with it.
+mf::mappedMaze mf::mapMaze(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Could not open " + path);
+    }
+    const off_t length = lseek(fd, 0, SEEK_END);
+    void* mapping = length >= (off_t)HEADER_LENGTH ? mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    // The mapping stays valid after the file descriptor is closed
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map " + path);
+    }
+
+    const auto* bytes = static_cast<const unsigned char*>(mapping);
+    std::int32_t rows, cols;
+    std::memcpy(&rows, bytes + sizeof(MAGIC), sizeof(rows));
+    std::memcpy(&cols, bytes + sizeof(MAGIC) + sizeof(rows), sizeof(cols));
+    if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0 || rows <= 0 || cols <= 0 ||
+        HEADER_LENGTH + (std::size_t)rows * cols > (std::size_t)length) {
+        munmap(mapping, length);
+        throw std::runtime_error(path + " is not a maze file");
+    }
+
+    // The source points at the first cell. The column count sits just before it, at the end of the header.
+    auto read = [](const void* source, int x, int y) -> int {
+        const auto* cells = static_cast<const unsigned char*>(source);
+        std::int32_t cols;
+        std::memcpy(&cols, cells - sizeof(cols), sizeof(cols));
+        return cells[(std::size_t)y * cols + x];
+    };
+    return mappedMaze{cellReader{rows, cols, bytes + HEADER_LENGTH, read}, mapping, (std::size_t)length};
+}
+
+void mf::unmapMaze(mappedMaze& maze) {
+    munmap(maze.mapping, maze.length);
+    maze.mapping = nullptr;
+    maze.length = 0;
+}
@@ -0,0 +1,26 @@
+#ifndef MAZE_FILE_H
+#define MAZE_FILE_H
+
+#include <cstddef>
+#include <string>
+#include "utils.h"
+
+using namespace utils;
+
+namespace mf {
+
+// A maze file mapped into memory. Cells are paged in by the OS as they're read, so the maze can be far larger
+// than the available RAM.
+struct mappedMaze {
+    cellReader cells;
+    void* mapping;
+    std::size_t length;
+};
+
+void writeMaze(const gridType& grid, const std::string& path);
+mappedMaze mapMaze(const std::string& path);
+void unmapMaze(mappedMaze& maze);
+
+}  // namespace mf
+
+#endif /* MAZE_FILE_H */
@@ -0,0 +1,177 @@
+// Draw mazes zoomed out so far that a cell is smaller than a pixel. Each level of the pyramid sums up the walls of
+// blocks of cells, and how many of them a search has visited or found to be on the solution, so a zoomed out frame
+// draws one shaded rectangle per block instead of every cell. The levels are built on several threads at once, and
+// updated cell by cell after that.
+
+#include "overview.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include "constants.cpp"
+#include "render.h"
+#include "viewer.h"
+
+using namespace constants;
+
+// How strongly a block's color leans towards the visited color once all of its cells have been visited, so that its
+// walls can still be made out
+static const float VISITED_WEIGHT = 0.6f;
+
+// Call work(first, last) for shares of the rows from 0 up to rows, each share on its own thread
+template <typename Work>
+static void splitRows(const int rows, const int threadCount, Work&& work) {
+    const int share = (rows + threadCount - 1) / threadCount;
+    std::vector<std::thread> threads = {};
+    for (int first = share; first < rows; first += share) {
+        threads.emplace_back(work, first, std::min(first + share, rows));
+    }
+    work(0, std::min(share, rows));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// Add delta to the given total of every block holding the cell, at every level
+static void addToBlocks(ov::pyramid& overview,
+                        const XY& cell,
+                        std::vector<std::uint32_t> ov::level::*totals,
+                        const int delta) {
+    for (std::size_t k = 0; k < overview.levels.size(); k++) {
+        ov::level& blocks = overview.levels[k];
+        // A negative delta wraps around, which still subtracts it
+        (blocks.*totals)[(std::size_t)(cell.y >> (k + 1)) * blocks.cols + (cell.x >> (k + 1))] += delta;
+    }
+}
+
+// Count the walls the cell owns again, after they may have changed
+static void recountWalls(ov::pyramid& overview, const gridType& grid, const int x, const int y) {
+    if (x < 0 || y < 0 || !inBounds(grid, x, y)) {
+        return;
+    }
+    const int count = !isConnected(grid, {x, y}, EAST) + !isConnected(grid, {x, y}, SOUTH);
+    std::uint8_t& state = overview.cells[(std::size_t)y * overview.cols + x];
+    const int delta = count - (state & 3);
+    if (delta != 0) {
+        state = (state & ~3) | count;
+        addToBlocks(overview, {x, y}, &ov::level::walls, delta);
+    }
+}
+
+// Return the color part of the way from one color to another, where 0 is the first and 1 the second
+static Color mix(const Color from, const Color to, const float amount) {
+    const float t = std::clamp(amount, 0.0f, 1.0f);
+    return {(unsigned char)(from.r + (to.r - from.r) * t + 0.5f), (unsigned char)(from.g + (to.g - from.g) * t + 0.5f),
+            (unsigned char)(from.b + (to.b - from.b) * t + 0.5f), 255};
+}
+
+// Sum up the walls of the grid at every level, splitting each level between the given number of threads. 0 threads
+// means one per core.
+ov::pyramid ov::build(const gridType& grid, int threadCount) {
+    if (threadCount < 0)
+        throw std::invalid_argument("The thread count can't be negative");
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const int rows = grid.size();
+    const int cols = grid.at(0).size();
+    pyramid overview = {rows, cols, std::vector<std::uint8_t>((std::size_t)rows * cols), {}};
+    int levelRows = rows, levelCols = cols, size = 1;
+    do {
+        levelRows = (levelRows + 1) / 2;
+        levelCols = (levelCols + 1) / 2;
+        size *= 2;
+        const std::size_t blockCount = (std::size_t)levelRows * levelCols;
+        overview.levels.push_back({levelRows, levelCols, size, std::vector<std::uint32_t>(blockCount),
+                                   std::vector<std::uint32_t>(blockCount), std::vector<std::uint32_t>(blockCount)});
+    } while (levelRows > 1 || levelCols > 1);
+
+    // The first level is summed from the cells. Each thread writes to its own rows of cells and of blocks.
+    level& first = overview.levels[0];
+    splitRows(first.rows, threadCount, [&](const int firstRow, const int lastRow) {
+        for (int y = firstRow * 2; y < std::min(lastRow * 2, rows); y++) {
+            for (int x = 0; x < cols; x++) {
+                const int count = !isConnected(grid, {x, y}, EAST) + !isConnected(grid, {x, y}, SOUTH);
+                overview.cells[(std::size_t)y * cols + x] = count;
+                first.walls[(std::size_t)(y / 2) * first.cols + x / 2] += count;
+            }
+        }
+    });
+
+    // Each level after that is summed from the one before
+    for (std::size_t k = 1; k < overview.levels.size(); k++) {
+        const level& below = overview.levels[k - 1];
+        level& blocks = overview.levels[k];
+        splitRows(blocks.rows, threadCount, [&](const int firstRow, const int lastRow) {
+            for (int y = firstRow * 2; y < std::min(lastRow * 2, below.rows); y++) {
+                for (int x = 0; x < below.cols; x++) {
+                    const std::uint32_t walls = below.walls[(std::size_t)y * below.cols + x];
+                    blocks.walls[(std::size_t)(y / 2) * blocks.cols + x / 2] += walls;
+                }
+            }
+        });
+    }
+    return overview;
+}
+
+// Update the walls after the grid has changed around the cell
+void ov::updateWalls(pyramid& overview, const gridType& grid, const XY& cell) {
+    // The walls on the north and west sides of the cell belong to its neighbors
+    recountWalls(overview, grid, cell.x, cell.y);
+    recountWalls(overview, grid, cell.x - 1, cell.y);
+    recountWalls(overview, grid, cell.x, cell.y - 1);
+}
+
+// Count the cell as visited, if it isn't already
+void ov::markVisited(pyramid& overview, const XY& cell) {
+    std::uint8_t& state = overview.cells[(std::size_t)cell.y * overview.cols + cell.x];
+    if ((state & VISITED_BIT) == 0) {
+        state |= VISITED_BIT;
+        addToBlocks(overview, cell, &level::visited, 1);
+    }
+}
+
+// Count the cell as on the solution, if it isn't already
+void ov::markSolution(pyramid& overview, const XY& cell) {
+    std::uint8_t& state = overview.cells[(std::size_t)cell.y * overview.cols + cell.x];
+    if ((state & SOLUTION_BIT) == 0) {
+        state |= SOLUTION_BIT;
+        addToBlocks(overview, cell, &level::solution, 1);
+    }
+}
+
+// Return the number of cells counted as visited
+std::uint32_t ov::visitedCount(const pyramid& overview) {
+    return overview.levels.empty() ? 0 : overview.levels.back().visited[0];
+}
+
+// Draw the blocks of the given level which the camera shows, level 1 being blocks of 2 by 2 cells. Each block is
+// shaded by the share of its cells' walls which are standing, then tinted by how many of its cells have been visited,
+// and by how many are on the solution. Expects an open window or canvas.
+void ov::draw(const pyramid& overview,
+              const int detailLevel,
+              const Color background,
+              const Color wall,
+              const Color visited,
+              const Color solution) {
+    if (detailLevel < 1) {
+        return;
+    }
+    const level& blocks = overview.levels[std::min<std::size_t>(detailLevel, overview.levels.size()) - 1];
+    const int size = blocks.blockSize;
+    const vw::cellRange visible = vw::visibleCells(overview.rows, overview.cols);
+    for (int y = visible.minY / size; y < (visible.maxY + size - 1) / size; y++) {
+        const int height = std::min((y + 1) * size, overview.rows) - y * size;
+        for (int x = visible.minX / size; x < (visible.maxX + size - 1) / size; x++) {
+            const int width = std::min((x + 1) * size, overview.cols) - x * size;
+            const int cellCount = width * height;
+            const std::size_t idx = (std::size_t)y * blocks.cols + x;
+            Color clr = mix(background, wall, blocks.walls[idx] / (2.0f * cellCount));
+            clr = mix(clr, visited, VISITED_WEIGHT * blocks.visited[idx] / cellCount);
+            // A path crosses a block through about one cell per row, so this is full strength for a path straight
+            // through it
+            clr = mix(clr, solution, (float)blocks.solution[idx] / size);
+            rd::rectangle(x * size * CELLWIDTH, y * size * CELLHEIGHT, width * CELLWIDTH, height * CELLHEIGHT, clr);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef OVERVIEW_H
+#define OVERVIEW_H
+
+#include <cstdint>
+#include <vector>
+#include "../lib/raylib.h"
+#include "utils.h"
+
+using namespace utils;
+
+namespace ov {
+
+// The totals for one level of the pyramid, for blocks of blockSize by blockSize cells, row by row. Blocks along the
+// south and east edges of the maze may hold fewer cells.
+struct level {
+    int rows;
+    int cols;
+    int blockSize;
+    // The number of walls the block's cells own, and the number of them visited and on the solution
+    std::vector<std::uint32_t> walls;
+    std::vector<std::uint32_t> visited;
+    std::vector<std::uint32_t> solution;
+};
+
+// A maze summarized at ever coarser levels of detail, like a texture's mipmaps, so that it can be drawn zoomed out with
+// one rectangle per pixel rather than many cells per pixel. The overlays are kept up to date as a search goes on.
+struct pyramid {
+    int rows;
+    int cols;
+    // For each cell, the number of walls it owns in the low two bits, then VISITED_BIT and SOLUTION_BIT
+    std::vector<std::uint8_t> cells;
+    // levels[0] holds blocks of 2 by 2 cells, and each level after it blocks twice the size, up to a single block
+    std::vector<level> levels;
+};
+
+inline constexpr std::uint8_t VISITED_BIT = 4;
+inline constexpr std::uint8_t SOLUTION_BIT = 8;
+
+pyramid build(const gridType& grid, int threadCount);
+void updateWalls(pyramid& overview, const gridType& grid, const XY& cell);
+void markVisited(pyramid& overview, const XY& cell);
+void markSolution(pyramid& overview, const XY& cell);
+std::uint32_t visitedCount(const pyramid& overview);
+void draw(const pyramid& overview,
+          const int detailLevel,
+          const Color background,
+          const Color wall,
+          const Color visited,
+          const Color solution);
+
+}  // namespace ov
+
+#endif /* OVERVIEW_H */
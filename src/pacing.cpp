@@ -0,0 +1,94 @@
+// Decide how many simulation steps each frame of an animation takes. One step per frame is far too slow to watch a
+// large maze being generated or solved, so the number can be raised while the animation runs, or worked out from how
+// long the animation should take in all.
+
+#include "pacing.h"
+#include <algorithm>
+#include "../lib/raylib.h"
+#include "constants.cpp"
+#include "hud.h"
+#include "render.h"
+
+using namespace constants;
+
+// The largest number of steps per frame the keyboard can ask for
+static const int MAX_STEPS_PER_FRAME = 1 << 20;
+
+static int g_stepsPerFrame = STEPS_PER_FRAME;
+static bool g_finishInTime = currentPacingMode == PACE_FINISH_IN_TIME;
+static long long g_expectedSteps = 0;
+static int g_fps = 1;
+// The steps taken and frames drawn since begin
+static long long g_stepsTaken = 0;
+static long long g_framesDrawn = 0;
+
+void pc::begin(const long long expectedSteps, const int fps) {
+    g_expectedSteps = expectedSteps;
+    g_fps = std::max(1, fps);
+    g_stepsTaken = 0;
+    g_framesDrawn = 0;
+}
+
+// Respond to the keyboard: = and - double and halve the steps per frame, and F switches between those and finishing in
+// FINISH_IN_SECONDS. Call once per frame, before advance. Without a window there's nothing to respond to.
+void pc::update() {
+    if (rd::isHeadless()) {
+        return;
+    }
+    if (IsKeyPressed(KEY_EQUAL)) {
+        g_stepsPerFrame = std::min(g_stepsPerFrame * 2, MAX_STEPS_PER_FRAME);
+        g_finishInTime = false;
+    }
+    if (IsKeyPressed(KEY_MINUS)) {
+        g_stepsPerFrame = std::max(g_stepsPerFrame / 2, 1);
+        g_finishInTime = false;
+    }
+    if (IsKeyPressed(KEY_F)) {
+        g_finishInTime = !g_finishInTime;
+    }
+}
+
+// Return the number of steps this frame should take. Finishing in time, the steps left are shared between the frames
+// left, so an animation which turns out longer than expected speeds up towards the end. Always at least one.
+long long pc::stepsThisFrame() {
+    if (!g_finishInTime) {
+        return g_stepsPerFrame;
+    }
+    const long long framesLeft = std::max(1LL, (long long)(FINISH_IN_SECONDS * g_fps) - g_framesDrawn);
+    const long long stepsLeft = g_expectedSteps - g_stepsTaken;
+    return std::max(1LL, (stepsLeft + framesLeft - 1) / framesLeft);
+}
+
+// Whether a frame which started taking steps at frameStart has spent its share, STEP_TIME_BUDGET, of the frame's time.
+// Headless frames have no budget, so that what each one shows doesn't depend on how fast the machine is.
+bool pc::budgetSpent(const std::chrono::steady_clock::time_point& frameStart) {
+    if (rd::isHeadless()) {
+        return false;
+    }
+    const std::chrono::duration<double> spent = std::chrono::steady_clock::now() - frameStart;
+    return spent.count() >= STEP_TIME_BUDGET / g_fps;
+}
+
+// Record the steps taken by a frame which started taking them at frameStart
+void pc::finishFrame(const long long steps, const std::chrono::steady_clock::time_point& frameStart) {
+    hd::recordSimulation(frameStart, steps);
+    g_stepsTaken += steps;
+    g_framesDrawn++;
+}
+
+// Return how many steps a second a simulation running on a thread of its own should take, given the rate it takes at
+// one step per frame, or 0 to take as many as it can. Finishing in time, the rate is set by the expected steps instead.
+int pc::stepsPerSecond(const int baseRate) {
+    if (g_finishInTime) {
+        return std::max(1, (int)std::min<double>(g_expectedSteps / FINISH_IN_SECONDS, 1e9));
+    }
+    return baseRate > 0 ? (int)std::min<long long>((long long)baseRate * g_stepsPerFrame, 1000000000LL) : 0;
+}
+
+int pc::stepsPerFrame() {
+    return g_stepsPerFrame;
+}
+
+bool pc::finishingInTime() {
+    return g_finishInTime;
+}
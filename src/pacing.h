@@ -0,0 +1,38 @@
+#ifndef PACING_H
+#define PACING_H
+
+#include <chrono>
+
+namespace pc {
+
+// Start pacing an animation which is expected to take about expectedSteps steps, drawn at fps frames a second. The
+// number of steps per frame, and whether to finish in a set time instead, carry over from the last animation.
+void begin(const long long expectedSteps, const int fps);
+void update();
+long long stepsThisFrame();
+bool budgetSpent(const std::chrono::steady_clock::time_point& frameStart);
+void finishFrame(const long long steps, const std::chrono::steady_clock::time_point& frameStart);
+int stepsPerSecond(const int baseRate);
+int stepsPerFrame();
+bool finishingInTime();
+
+// Call step until this frame's steps have been taken, or until it returns false to say that the animation has no steps
+// left. In a window, the frame stops taking steps once it has spent its time budget, so that a slow step can't hold up
+// drawing. Returns false if step did.
+template <typename Step>
+bool advance(Step&& step) {
+    const auto frameStart = std::chrono::steady_clock::now();
+    const long long quota = stepsThisFrame();
+    long long taken = 0;
+    bool more = true;
+    while (more && taken < quota && !(taken > 0 && budgetSpent(frameStart))) {
+        more = step();
+        taken++;
+    }
+    finishFrame(taken, frameStart);
+    return more;
+}
+
+}  // namespace pc
+
+#endif /* PACING_H */
@@ -0,0 +1,190 @@
+// Store solution paths compactly: the start cell, then two bits per step for the direction taken.
+// File layout: the 4 byte magic "PATH", the start cell's x and y as 32 bit integers, the number of cells as a 64 bit
+// integer, then the packed steps, exactly as they're held in memory.
+
+#include "packed_path.h"
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "constants.cpp"
+#include "utils.h"
+
+using namespace constants;
+
+static const char MAGIC[4] = {'P', 'A', 'T', 'H'};
+
+pp::cellIterator& pp::cellIterator::operator++() {
+    idx++;
+    if (idx < path->length) {
+        cell = neighborOf(cell, directionAt(*path, idx - 1));
+    }
+    return *this;
+}
+
+pp::cellIterator pp::cellIterator::operator++(int) {
+    cellIterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+pp::cellIterator pp::begin(const packedPath& path) {
+    return cellIterator{&path, 0, path.start};
+}
+
+pp::cellIterator pp::end(const packedPath& path) {
+    return cellIterator{&path, path.length, path.start};
+}
+
+// Return a path consisting of only the start cell
+pp::packedPath pp::startingAt(const XY& start) {
+    return packedPath{start, 1, {}};
+}
+
+// Return the direction of the step leaving the cell at position stepIdx of the path
+int pp::directionAt(const packedPath& path, const long long stepIdx) {
+    return DIRECTIONS[(path.steps[stepIdx / 4] >> (stepIdx % 4 * 2)) & 3];
+}
+
+// Extend the path by one step, unless that step leads straight back to the previous cell, in which case the previous
+// step is removed instead. Recording a walk this way drops every dead end the walk went into and came back out of.
+void pp::appendRetracing(packedPath& path, const int direction) {
+    if (path.length > 1 && directionAt(path, path.length - 2) == oppositeOf(direction)) {
+        path.length--;
+        const long long stepIdx = path.length - 1;
+        if (stepIdx % 4 == 0) {
+            path.steps.pop_back();
+        } else {
+            path.steps.back() &= ~(3 << (stepIdx % 4 * 2));
+        }
+        return;
+    }
+    append(path, direction);
+}
+
+// Extend the path by every step of the tail, which must start where the path ends. That isn't checked, since finding
+// the end of the path means walking all of it.
+void pp::appendPath(packedPath& path, const packedPath& tail) {
+    for (long long i = 0; i < tail.length - 1; i++) {
+        append(path, directionAt(tail, i));
+    }
+}
+
+// Return the last cell of the path
+XY pp::endOf(const packedPath& path) {
+    XY cell = path.start;
+    for (long long i = 0; i < path.length - 1; i++) {
+        cell = neighborOf(cell, directionAt(path, i));
+    }
+    return cell;
+}
+
+// Return the same path, walked from its end to its start
+pp::packedPath pp::reversed(const packedPath& path) {
+    if (path.length == 0)
+        return path;
+
+    packedPath result = startingAt(endOf(path));
+    result.steps.reserve(path.steps.size());
+    for (long long i = path.length - 2; i >= 0; i--) {
+        append(result, oppositeOf(directionAt(path, i)));
+    }
+    return result;
+}
+
+// Pack a list of cells, each of which must be next to the one before it
+pp::packedPath pp::pack(const std::vector<XY>& cells) {
+    if (cells.empty())
+        return packedPath{};
+
+    packedPath path = startingAt(cells.front());
+    path.steps.reserve(cells.size() / 4 + 1);
+    for (std::size_t i = 1; i < cells.size(); i++) {
+        append(path, directionTo(cells[i - 1], cells[i]));
+    }
+    return path;
+}
+
+// Recover a path from the order in which a search visited cells, for searches which don't record how they reached
+// each cell. visitOrder holds the step at which each cell was first visited, by cellIndex, or -1 if it wasn't. Every
+// visited cell other than the start was reached from a connected cell visited before it, so walking back from the end
+// to its earliest visited neighbor, over and over, must lead to the start. Empty if either end wasn't visited.
+pp::packedPath pp::traceBack(const gridType& grid, const std::vector<int>& visitOrder, const XY& end, const XY& start) {
+    const auto& order = visitOrder;
+    if (order[cellIndex(grid, start)] == -1 || order[cellIndex(grid, end)] == -1)
+        return packedPath{};
+
+    // Collect the steps from the end back to the start, then turn them around
+    packedPath backwards = startingAt(end);
+    for (XY current = end; !(current == start);) {
+        int bestDirection = 0;
+        int bestOrder = order[cellIndex(grid, current)];
+        for (const int direction : DIRECTIONS) {
+            if (isConnected(grid, current, direction)) {
+                const int neighborOrder = order[cellIndex(grid, neighborOf(current, direction))];
+                if (neighborOrder != -1 && neighborOrder < bestOrder) {
+                    bestOrder = neighborOrder;
+                    bestDirection = direction;
+                }
+            }
+        }
+        if (bestDirection == 0)
+            return packedPath{};
+        append(backwards, bestDirection);
+        current = neighborOf(current, bestDirection);
+    }
+    return reversed(backwards);
+}
+
+// Decode every cell of the path at once. Prefer iterating over the path where the cells are only needed one by one.
+std::vector<XY> pp::unpack(const packedPath& path) {
+    std::vector<XY> cells = {};
+    cells.reserve(path.length);
+    for (const XY& cell : path) {
+        cells.push_back(cell);
+    }
+    return cells;
+}
+
+// Write the path to the file with the given name, overwriting it if it exists
+void pp::writePath(const packedPath& path, const std::string& filename) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Could not open " + filename + " for writing");
+    }
+
+    const std::int32_t x = path.start.x;
+    const std::int32_t y = path.start.y;
+    const std::int64_t length = path.length;
+    file.write(MAGIC, sizeof(MAGIC));
+    file.write(reinterpret_cast<const char*>(&x), sizeof(x));
+    file.write(reinterpret_cast<const char*>(&y), sizeof(y));
+    file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    file.write(reinterpret_cast<const char*>(path.steps.data()), path.steps.size());
+}
+
+// Read back a path written by writePath
+pp::packedPath pp::readPath(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open " + filename);
+    }
+
+    char magic[sizeof(MAGIC)];
+    std::int32_t x, y;
+    std::int64_t length;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&x), sizeof(x));
+    file.read(reinterpret_cast<char*>(&y), sizeof(y));
+    file.read(reinterpret_cast<char*>(&length), sizeof(length));
+    if (!file || std::string(magic, sizeof(magic)) != std::string(MAGIC, sizeof(MAGIC)) || length < 0) {
+        throw std::runtime_error(filename + " is not a path file");
+    }
+
+    packedPath path = {{x, y}, length, std::vector<std::uint8_t>(length > 0 ? (length - 1 + 3) / 4 : 0)};
+    file.read(reinterpret_cast<char*>(path.steps.data()), path.steps.size());
+    if (!file) {
+        throw std::runtime_error(filename + " is truncated");
+    }
+    return path;
+}
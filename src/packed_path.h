@@ -0,0 +1,81 @@
+#ifndef PACKED_PATH_H
+#define PACKED_PATH_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+using namespace utils;
+
+namespace pp {
+
+// A path through a maze, stored as its first cell plus two bits per step. A path of ten million steps takes 2.5 MB,
+// where a vector of XYs would take 80 MB. Iterate over it to get its cells, e.g. `for (const XY& cell : path)`.
+struct packedPath {
+    XY start;
+    // The number of cells on the path, including the start. 0 if there is no path.
+    long long length;
+    // Four steps per byte, starting from the lowest two bits. Each step is an index into constants::DIRECTIONS.
+    std::vector<std::uint8_t> steps;
+
+    bool operator==(const packedPath& other) const = default;
+};
+
+// Decodes the cells of a packed path one at a time, so that the whole path never needs to exist as XYs
+struct cellIterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = XY;
+    using difference_type = long long;
+    using pointer = const XY*;
+    using reference = const XY&;
+
+    const packedPath* path;
+    // The position of the current cell on the path
+    long long idx;
+    XY cell;
+
+    reference operator*() const { return cell; }
+    pointer operator->() const { return &cell; }
+    cellIterator& operator++();
+    cellIterator operator++(int);
+    bool operator==(const cellIterator& other) const { return idx == other.idx; }
+};
+
+cellIterator begin(const packedPath& path);
+cellIterator end(const packedPath& path);
+
+// Extend the path by one step in the given direction. It's defined here so that it can be inlined into the loops
+// which build paths, where a call per step would cost more than the step itself.
+inline void append(packedPath& path, const int direction) {
+    // The directions are the single bits in the order of constants::DIRECTIONS, so a step's code is its bit position
+    if (path.length == 0 || direction <= 0 || direction > 8 || (direction & (direction - 1)) != 0)
+        throw std::invalid_argument("A step must go in exactly one direction, from a path with a start cell");
+
+    const long long stepIdx = path.length - 1;
+    if (stepIdx % 4 == 0) {
+        path.steps.push_back(0);
+    }
+    path.steps.back() |= std::countr_zero((unsigned)direction) << (stepIdx % 4 * 2);
+    path.length++;
+}
+
+void appendPath(packedPath& path, const packedPath& tail);
+void appendRetracing(packedPath& path, const int direction);
+int directionAt(const packedPath& path, const long long stepIdx);
+XY endOf(const packedPath& path);
+packedPath pack(const std::vector<XY>& cells);
+packedPath readPath(const std::string& filename);
+packedPath reversed(const packedPath& path);
+packedPath startingAt(const XY& start);
+packedPath traceBack(const gridType& grid, const std::vector<int>& visitOrder, const XY& end, const XY& start);
+std::vector<XY> unpack(const packedPath& path);
+void writePath(const packedPath& path, const std::string& filename);
+
+}  // namespace pp
+
+#endif /* PACKED_PATH_H */
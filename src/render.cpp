@@ -0,0 +1,495 @@
+// Draw frames either into a window, through raylib, or into a canvas in memory, so that animations can be rendered
+// on machines with no display or GPU.
+// The canvas backend fills its pixels itself rather than through ImageDrawRectangle, which overwrites pixels where the
+// window blends translucent colors into them. Both backends draw horizontal and vertical lines as rectangles one pixel
+// thick: a line along the edges of pixels can be rasterized differently by different GPUs, but a rectangle can't.
+// For the same reason, the camera is applied here, to whole pixels, rather than by raylib's BeginMode2D.
+// An animation can mark the part of a canvas frame it changes, and everything drawn into the frame is then clipped to
+// that part, so a frame which changes a few cells only costs a few cells to draw and to encode.
+
+#include "render.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "constants.cpp"
+#include "log.h"
+#include "video_export.h"
+
+using namespace constants;
+
+// The canvas being drawn into, or nullptr when drawing into the window
+static rd::canvas* g_canvas = nullptr;
+// The canvas opened in place of a window by the headless backend
+static rd::canvas g_headlessCanvas = {};
+// Whether frames are written to HEADLESS_FRAME_PATH as they're finished
+static bool g_exportFrames = false;
+static int g_frameIdx = 0;
+// The video the frames are streamed into, if HEADLESS_VIDEO_PATH is set, and the number of animations opened so far
+static vx::videoStream g_video = {};
+static bool g_videoOpen = false;
+static int g_animationIdx = 0;
+// The canvas drawn into before beginLayer, to be restored by endLayer
+static rd::canvas* g_canvasOutsideLayer = nullptr;
+// Whether a frame has been finished, but not yet written. It can't be written in endFrame, because only the next call
+// to shouldClose says whether it's the animation's last.
+static bool g_framePending = false;
+// The camera shapes and text are drawn through
+static Camera2D g_camera = {{0, 0}, {0, 0}, 0, 1};
+// What the canvas frame being drawn changes: nothing yet, the marked rectangle, or possibly any pixel
+enum dirtyState { NOTHING_MARKED, RECT_MARKED, WHOLE_FRAME };
+static dirtyState g_dirtyState = WHOLE_FRAME;
+static rd::frameRect g_dirty = {0, 0, 0, 0};
+// The camera the canvas' last frame was drawn through, if it has had one. Marks only hold while the camera stays put.
+static bool g_hasPreviousFrame = false;
+static Camera2D g_previousCamera = {};
+// What the frames finished since the last one written to the video change, together
+static rd::frameRect g_unwritten = {0, 0, 0, 0};
+// Text is left out when the camera is zoomed out further than this, since it would be too small to read
+static const float MIN_TEXT_ZOOM = 0.5f;
+
+// Blend a translucent color over another, as the window does with its default blend mode
+static Color blend(const Color below, const Color above) {
+    const int a = above.a;
+    return {(unsigned char)((above.r * a + below.r * (255 - a) + 127) / 255),
+            (unsigned char)((above.g * a + below.g * (255 - a) + 127) / 255),
+            (unsigned char)((above.b * a + below.b * (255 - a) + 127) / 255),
+            (unsigned char)(a + (below.a * (255 - a) + 127) / 255)};
+}
+
+// Map maze coordinates to the frame's, rounding down to whole pixels. The default camera leaves them as they are.
+static int frameX(const int x) {
+    return (int)std::floor((x - (double)g_camera.target.x) * g_camera.zoom + g_camera.offset.x);
+}
+
+static int frameY(const int y) {
+    return (int)std::floor((y - (double)g_camera.target.y) * g_camera.zoom + g_camera.offset.y);
+}
+
+// Map a rectangle from maze coordinates to the frame's. A rectangle with any area keeps at least one pixel each way,
+// so that walls stay visible when zoomed out.
+static rd::frameRect toFrame(const int x, const int y, const int width, const int height) {
+    const int left = frameX(x);
+    const int top = frameY(y);
+    return {left, top, width > 0 ? std::max(frameX(x + width), left + 1) : left,
+            height > 0 ? std::max(frameY(y + height), top + 1) : top};
+}
+
+static bool isEmpty(const rd::frameRect& rect) {
+    return rect.right <= rect.left || rect.bottom <= rect.top;
+}
+
+static rd::frameRect intersect(const rd::frameRect& a, const rd::frameRect& b) {
+    return {std::max(a.left, b.left), std::max(a.top, b.top), std::min(a.right, b.right),
+            std::min(a.bottom, b.bottom)};
+}
+
+// The smallest rectangle holding both
+static rd::frameRect unite(const rd::frameRect& a, const rd::frameRect& b) {
+    if (isEmpty(a)) {
+        return b;
+    }
+    if (isEmpty(b)) {
+        return a;
+    }
+    return {std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right),
+            std::max(a.bottom, b.bottom)};
+}
+
+static rd::frameRect wholeCanvas() {
+    return {0, 0, g_canvas->width, g_canvas->height};
+}
+
+static bool isWholeCanvas(const rd::frameRect& rect) {
+    return rect.left == 0 && rect.top == 0 && rect.right == g_canvas->width && rect.bottom == g_canvas->height;
+}
+
+// The part of the canvas which drawing may change: all of a layer, or what was marked of a frame. Drawing into a frame
+// with nothing marked changes the whole frame.
+static rd::frameRect drawableRect() {
+    if (g_canvasOutsideLayer != nullptr) {
+        return wholeCanvas();
+    }
+    if (g_dirtyState == NOTHING_MARKED) {
+        g_dirtyState = WHOLE_FRAME;
+    }
+    return g_dirtyState == RECT_MARKED ? g_dirty : wholeCanvas();
+}
+
+static bool sameCamera(const Camera2D& a, const Camera2D& b) {
+    return a.offset.x == b.offset.x && a.offset.y == b.offset.y && a.target.x == b.target.x &&
+           a.target.y == b.target.y && a.zoom == b.zoom;
+}
+
+// Draw a diagonal line into the canvas, between two points in the frame. raylib can't clip it to the marked part of
+// the frame, so when only part may be drawn, the line is stepped along pixel by pixel instead.
+static void drawDiagonal(const int startX, const int startY, const int endX, const int endY, const Color color) {
+    const rd::frameRect clip = drawableRect();
+    Image image = rd::imageOf(*g_canvas);
+    if (isWholeCanvas(clip)) {
+        ImageDrawLine(&image, startX, startY, endX, endY, color);
+        return;
+    }
+    const int steps = std::max({1, std::abs(endX - startX), std::abs(endY - startY)});
+    for (int i = 0; i <= steps; i++) {
+        const int x = startX + (int)std::lround((double)(endX - startX) * i / steps);
+        const int y = startY + (int)std::lround((double)(endY - startY) * i / steps);
+        if (x >= clip.left && x < clip.right && y >= clip.top && y < clip.bottom) {
+            Color& pixel = g_canvas->pixels[(std::size_t)y * g_canvas->width + x];
+            pixel = color.a == 255 ? color : blend(pixel, color);
+        }
+    }
+}
+
+// Format a number into a file name pattern from constants.cpp, e.g. HEADLESS_FRAME_PATH
+static std::string numberedFileName(const char* pattern, const int number) {
+    char fileName[512];
+    std::snprintf(fileName, sizeof(fileName), pattern, number);
+    return fileName;
+}
+
+static void writePendingFrame(const bool last) {
+    if (!g_framePending) {
+        return;
+    }
+    g_framePending = false;
+    // Frames skipped by the interval still change the video's next frame
+    g_unwritten = unite(g_unwritten, rd::dirtyRect());
+    if (g_exportFrames && g_videoOpen && (last || g_frameIdx % HEADLESS_FRAME_INTERVAL == 0)) {
+        vx::writeFrame(g_video, *g_canvas, g_unwritten);
+        g_unwritten = {0, 0, 0, 0};
+    } else if (g_exportFrames && (last || g_frameIdx % HEADLESS_FRAME_INTERVAL == 0)) {
+        const std::string fileName = numberedFileName(HEADLESS_FRAME_PATH, g_frameIdx);
+        if (!rd::exportFrame(*g_canvas, fileName.c_str())) {
+            MAZE_LOG(LEVEL_WARNING, LOG_RENDER, "failed to write frame " << g_frameIdx << " to " << fileName);
+        }
+    }
+    g_frameIdx++;
+}
+
+// Return a canvas of the given size, with every pixel transparent
+rd::canvas rd::makeCanvas(const int width, const int height) {
+    return {width, height, std::vector<Color>((std::size_t)width * height, BLANK)};
+}
+
+// Return an Image which shares the canvas' pixels. It must not be unloaded, and is only valid until the canvas is
+// resized or destroyed.
+Image rd::imageOf(canvas& target) {
+    return {target.pixels.data(), target.width, target.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+}
+
+// Write the canvas to an image file, whose format is chosen by its extension. Returns true on success.
+bool rd::exportFrame(canvas& target, const char* fileName) {
+    return ExportImage(imageOf(target), fileName);
+}
+
+// Encode the canvas in the given image format, e.g. ".png". Returns no bytes on failure.
+std::vector<unsigned char> rd::exportFrameToMemory(canvas& target, const char* fileType) {
+    int fileSize = 0;
+    unsigned char* data = ExportImageToMemory(imageOf(target), fileType, &fileSize);
+    if (data == nullptr) {
+        return {};
+    }
+    std::vector<unsigned char> bytes(data, data + fileSize);
+    MemFree(data);
+    return bytes;
+}
+
+Color rd::pixelAt(const canvas& target, const int x, const int y) {
+    return target.pixels[(std::size_t)y * target.width + x];
+}
+
+// Draw into the canvas from now on. Its first frame is drawn whole.
+void rd::useCanvas(canvas* target) {
+    g_canvas = target;
+    g_dirtyState = WHOLE_FRAME;
+    g_hasPreviousFrame = false;
+}
+
+bool rd::isHeadless() {
+    return g_canvas != nullptr;
+}
+
+int rd::frameWidth() {
+    return isHeadless() ? g_canvas->width : GetScreenWidth();
+}
+
+int rd::frameHeight() {
+    return isHeadless() ? g_canvas->height : GetScreenHeight();
+}
+
+void rd::useCamera(const Camera2D& camera) {
+    g_camera = camera;
+}
+
+const Camera2D& rd::currentCamera() {
+    return g_camera;
+}
+
+// Return a layer of the given size, with every pixel transparent
+rd::layer rd::loadLayer(const int width, const int height) {
+    layer loaded = {width, height, isHeadless(), {}, {}};
+    if (loaded.inMemory) {
+        loaded.pixels = makeCanvas(width, height);
+        return loaded;
+    }
+    loaded.texture = LoadRenderTexture(width, height);
+    BeginTextureMode(loaded.texture);
+    ClearBackground(BLANK);
+    EndTextureMode();
+    return loaded;
+}
+
+void rd::unloadLayer(layer& target) {
+    if (target.inMemory) {
+        target.pixels = {};
+    } else {
+        UnloadRenderTexture(target.texture);
+        target.texture = {};
+    }
+}
+
+void rd::beginLayer(layer& target) {
+    if (!target.inMemory) {
+        BeginTextureMode(target.texture);
+        return;
+    }
+    g_canvasOutsideLayer = g_canvas;
+    g_canvas = &target.pixels;
+}
+
+void rd::endLayer() {
+    if (!isHeadless()) {
+        EndTextureMode();
+        return;
+    }
+    g_canvas = g_canvasOutsideLayer;
+    g_canvasOutsideLayer = nullptr;
+}
+
+// Draw the layer into the frame with its top left corner at x, y. Transparent pixels are left as they are.
+void rd::drawLayer(layer& source, const int x, const int y) {
+    if (!source.inMemory) {
+        // Render textures are stored upside down, so the source rectangle is flipped
+        DrawTextureRec(source.texture.texture, {0, 0, (float)source.width, -(float)source.height},
+                       {(float)x, (float)y}, WHITE);
+        return;
+    }
+    const frameRect area = intersect({x, y, x + source.width, y + source.height}, drawableRect());
+    const int left = area.left;
+    const int right = area.right;
+    for (int row = area.top; row < area.bottom; row++) {
+        const Color* from = source.pixels.pixels.data() + (std::size_t)(row - y) * source.width;
+        Color* to = g_canvas->pixels.data() + (std::size_t)row * g_canvas->width;
+        for (int col = left; col < right; col++) {
+            const Color pixel = from[col - x];
+            if (pixel.a == 255) {
+                to[col] = pixel;
+            } else if (pixel.a != 0) {
+                to[col] = blend(to[col], pixel);
+            }
+        }
+    }
+}
+
+void rd::open(const int width, const int height, const char* title) {
+    if (currentRenderBackend == WINDOW_BACKEND) {
+        InitWindow(width, height, title);
+        return;
+    }
+    g_headlessCanvas = makeCanvas(width, height);
+    g_exportFrames = true;
+    useCanvas(&g_headlessCanvas);
+    if (HEADLESS_VIDEO_PATH[0] != '\0') {
+        const std::string fileName = numberedFileName(HEADLESS_VIDEO_PATH, g_animationIdx);
+        g_videoOpen = vx::open(g_video, fileName.c_str(), width, height, VIDEO_FPS);
+        if (!g_videoOpen) {
+            MAZE_LOG(LEVEL_WARNING, LOG_RENDER, "failed to open video " << fileName << ", writing frames instead");
+        }
+        g_unwritten = {0, 0, 0, 0};
+    }
+    g_animationIdx++;
+}
+
+void rd::close() {
+    lg::flush();
+    if (!isHeadless()) {
+        CloseWindow();
+        return;
+    }
+    writePendingFrame(true);
+    if (g_videoOpen) {
+        vx::close(g_video);
+        g_videoOpen = false;
+    }
+    g_exportFrames = false;
+    useCanvas(nullptr);
+}
+
+void rd::setTargetFPS(const int fps) {
+    if (!isHeadless()) {
+        SetTargetFPS(fps);
+    }
+}
+
+bool rd::shouldClose(const bool done) {
+    if (!isHeadless()) {
+        return WindowShouldClose();  // Detect window close button or ESC key
+    }
+    writePendingFrame(done);
+    return done;
+}
+
+void rd::beginFrame() {
+    if (!isHeadless()) {
+        BeginDrawing();
+        return;
+    }
+    writePendingFrame(false);
+    g_dirtyState = NOTHING_MARKED;
+}
+
+// Finish the frame, and write out what was logged while drawing it, so that the console keeps up with the animation
+void rd::endFrame() {
+    lg::flush();
+    if (!isHeadless()) {
+        EndDrawing();
+        return;
+    }
+    g_framePending = true;
+    g_previousCamera = g_camera;
+    g_hasPreviousFrame = true;
+}
+
+// Add the rectangle, in maze coordinates, to what the frame being drawn changes. Once the camera has moved, every
+// pixel may have changed, so the frame is drawn whole.
+void rd::markDirty(const int x, const int y, const int width, const int height) {
+    if (!isHeadless() || g_dirtyState == WHOLE_FRAME) {
+        return;
+    }
+    if (!g_hasPreviousFrame || !sameCamera(g_previousCamera, g_camera)) {
+        g_dirtyState = WHOLE_FRAME;
+        return;
+    }
+    const frameRect area = intersect(toFrame(x, y, width, height), wholeCanvas());
+    g_dirty = g_dirtyState == RECT_MARKED ? unite(g_dirty, area) : area;
+    g_dirtyState = RECT_MARKED;
+}
+
+rd::frameRect rd::dirtyRect() {
+    if (isHeadless() && g_dirtyState == RECT_MARKED) {
+        return g_dirty;
+    }
+    if (isHeadless() && g_dirtyState == NOTHING_MARKED) {
+        return {0, 0, 0, 0};
+    }
+    return {0, 0, frameWidth(), frameHeight()};
+}
+
+void rd::clear(const Color color) {
+    if (!isHeadless()) {
+        ClearBackground(color);
+        return;
+    }
+    const frameRect area = drawableRect();
+    for (int row = area.top; row < area.bottom; row++) {
+        Color* pixels = g_canvas->pixels.data() + (std::size_t)row * g_canvas->width;
+        std::fill(pixels + area.left, pixels + area.right, color);
+    }
+}
+
+// Make the pixels in the rectangle transparent, rather than drawing over them, e.g. to redraw part of a layer
+void rd::erase(const int x, const int y, const int width, const int height) {
+    const frameRect area = toFrame(x, y, width, height);
+    if (!isHeadless()) {
+        // Subtracting the destination from a transparent color leaves nothing of either
+        BeginBlendMode(BLEND_SUBTRACT_COLORS);
+        DrawRectangle(area.left, area.top, area.right - area.left, area.bottom - area.top, BLANK);
+        EndBlendMode();
+        return;
+    }
+    const frameRect clipped = intersect(area, drawableRect());
+    for (int row = clipped.top; row < clipped.bottom && clipped.left < clipped.right; row++) {
+        Color* pixels = g_canvas->pixels.data() + (std::size_t)row * g_canvas->width;
+        std::fill(pixels + clipped.left, pixels + clipped.right, BLANK);
+    }
+}
+
+void rd::line(const int startX, const int startY, const int endX, const int endY, const Color color) {
+    // A line covers the pixels from its start up to, but not including, its end, as it does in the window
+    if (startY == endY) {
+        rectangle(std::min(startX, endX), startY, std::abs(endX - startX), 1, color);
+    } else if (startX == endX) {
+        rectangle(startX, std::min(startY, endY), 1, std::abs(endY - startY), color);
+    } else if (!isHeadless()) {
+        DrawLine(frameX(startX), frameY(startY), frameX(endX), frameY(endY), color);
+    } else {
+        // Nothing in the maze is drawn diagonally, so these needn't match the window exactly
+        drawDiagonal(frameX(startX), frameY(startY), frameX(endX), frameY(endY), color);
+    }
+}
+
+void rd::rectangle(const int x, const int y, const int width, const int height, const Color color) {
+    const frameRect area = toFrame(x, y, width, height);
+    if (!isHeadless()) {
+        DrawRectangle(area.left, area.top, area.right - area.left, area.bottom - area.top, color);
+        return;
+    }
+    const frameRect clipped = intersect(area, drawableRect());
+    const int left = clipped.left;
+    const int right = clipped.right;
+    const int top = clipped.top;
+    const int bottom = clipped.bottom;
+    if (color.a == 0 || left >= right || top >= bottom) {
+        return;
+    }
+    for (int row = top; row < bottom; row++) {
+        Color* pixels = g_canvas->pixels.data() + (std::size_t)row * g_canvas->width;
+        if (color.a == 255) {
+            std::fill(pixels + left, pixels + right, color);
+            continue;
+        }
+        for (int col = left; col < right; col++) {
+            pixels[col] = blend(pixels[col], color);
+        }
+    }
+}
+
+void rd::text(const char* message, const int x, const int y, const int fontSize, const Color color) {
+    if (!textShown()) {
+        return;
+    }
+    screenText(message, frameX(x), frameY(y), (int)(fontSize * g_camera.zoom), color);
+}
+
+bool rd::textShown() {
+    return g_camera.zoom >= MIN_TEXT_ZOOM;
+}
+
+void rd::screenText(const char* message, const int x, const int y, const int fontSize, const Color color) {
+    if (!isHeadless()) {
+        DrawText(message, x, y, fontSize, color);
+        return;
+    }
+    // Like DrawText, draw nothing until raylib has loaded its default font
+    if (GetFontDefault().texture.id == 0) {
+        return;
+    }
+    Image image = imageOf(*g_canvas);
+    const frameRect clip = drawableRect();
+    if (isWholeCanvas(clip)) {
+        ImageDrawText(&image, message, x, y, fontSize, color);
+        return;
+    }
+    // Only the part of the text inside the marked rectangle may be drawn, so render it apart first
+    Image rendered = ImageText(message, fontSize, color);
+    const frameRect area = intersect({x, y, x + rendered.width, y + rendered.height}, clip);
+    if (!isEmpty(area)) {
+        const float width = area.right - area.left;
+        const float height = area.bottom - area.top;
+        ImageDraw(&image, rendered, {(float)(area.left - x), (float)(area.top - y), width, height},
+                  {(float)area.left, (float)area.top, width, height}, WHITE);
+    }
+    UnloadImage(rendered);
+}
@@ -0,0 +1,100 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <vector>
+#include "../lib/raylib.h"
+
+namespace rd {
+
+// A frame drawn in memory instead of in a window. Pixels are stored row by row, in raylib's uncompressed R8G8B8A8
+// format, so imageOf can hand them to raylib's Image functions without copying.
+struct canvas {
+    int width;
+    int height;
+    std::vector<Color> pixels;
+};
+
+// A rectangle in the frame, in pixels. Right and bottom are one past its last column and row, so it's empty if
+// right <= left.
+struct frameRect {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+// Something drawn once and kept from one frame to the next, to be drawn into each frame with drawLayer: a render
+// texture in the window, or a canvas without one. Only draw opaque colors into a layer. Translucent ones are blended
+// into its transparent pixels differently by the window and the canvas.
+struct layer {
+    int width;
+    int height;
+    // Whether the layer is the canvas below, rather than the texture
+    bool inMemory;
+    canvas pixels;
+    RenderTexture2D texture;
+};
+
+canvas makeCanvas(const int width, const int height);
+Image imageOf(canvas& target);
+bool exportFrame(canvas& target, const char* fileName);
+std::vector<unsigned char> exportFrameToMemory(canvas& target, const char* fileType);
+Color pixelAt(const canvas& target, const int x, const int y);
+
+// Draw into the given canvas from now on, or into the window if it's nullptr
+void useCanvas(canvas* target);
+bool isHeadless();
+// The size of the frame being drawn, in pixels
+int frameWidth();
+int frameHeight();
+
+// Shapes and text are given in maze coordinates, and drawn where the camera shows them. Its rotation is ignored. The
+// default camera shows the maze at its own size, with its top left corner at the frame's.
+void useCamera(const Camera2D& camera);
+const Camera2D& currentCamera();
+
+// Layers are kept in the window if one is open when they're loaded, so load them after rd::open. They're drawn at a
+// fixed place in the frame, rather than through the camera.
+layer loadLayer(const int width, const int height);
+void unloadLayer(layer& target);
+// Draw into the layer, instead of the frame, until endLayer is called. Layers can't be nested.
+void beginLayer(layer& target);
+void endLayer();
+void drawLayer(layer& source, const int x, const int y);
+
+// Open a window of the given size, or, if the headless backend is chosen in constants.cpp, a canvas of that size whose
+// frames are written to HEADLESS_FRAME_PATH, or streamed into a video at HEADLESS_VIDEO_PATH
+void open(const int width, const int height, const char* title);
+void close();
+
+// The frame loop. Each animation runs while (!shouldClose(done)), where done says that the frame just drawn is its
+// last. A window ignores done, and stays open until it's closed. Without a window, nothing waits on the frame rate, and
+// the loop ends as soon as the animation does.
+void setTargetFPS(const int fps);
+bool shouldClose(const bool done);
+void beginFrame();
+void endFrame();
+
+// Canvas only: what a frame changes. An animation which knows which cells it changed since the last frame marks them,
+// in maze coordinates, after beginFrame and before drawing. Drawing into the frame is then clipped to what was marked,
+// the rest of the canvas keeps the frame before, and a video only encodes that part. A frame with nothing marked, or
+// whose camera has moved since the last frame, is drawn whole. The window ignores marks.
+void markDirty(const int x, const int y, const int width, const int height);
+// The part of the frame drawn since beginFrame which may differ from the frame before, or an empty rectangle
+frameRect dirtyRect();
+
+// Drawing. Both backends produce the same pixels, except for text, which needs the default font that raylib only
+// loads with a window. Shapes with any area cover at least one pixel each way, however far the camera is zoomed out.
+void clear(const Color color);
+void erase(const int x, const int y, const int width, const int height);
+void line(const int startX, const int startY, const int endX, const int endY, const Color color);
+void rectangle(const int x, const int y, const int width, const int height, const Color color);
+void text(const char* message, const int x, const int y, const int fontSize, const Color color);
+// Whether text drawn through the camera is shown, rather than left out as too small to read
+bool textShown();
+// Draw text at a fixed place in the frame, e.g. a status line, rather than through the camera
+void screenText(const char* message, const int x, const int y, const int fontSize, const Color color);
+
+}  // namespace rd
+
+#endif /* RENDER_H */
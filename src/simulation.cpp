@@ -0,0 +1,72 @@
+// Step a simulation on a thread of its own, at a steady rate or as fast as it will go
+
+#include "simulation.h"
+#include <algorithm>
+#include <chrono>
+
+typedef std::chrono::steady_clock simulationClock;
+
+// How often a simulation running as fast as it can publishes its changes. Often enough for every frame to see new
+// ones, but seldom enough that publishing costs little beside the steps themselves.
+static const auto PUBLISH_INTERVAL = std::chrono::milliseconds(2);
+// How many steps an unthrottled simulation takes between looks at the clock, which costs about as much as a step
+static const int STEPS_PER_CLOCK_CHECK = 64;
+// The longest a throttled simulation sleeps at once, so that stop never waits long for it
+static const auto LONGEST_SLEEP = std::chrono::milliseconds(10);
+
+// Start stepping the simulation, stepsPerSecond times a second, or as fast as possible if it's 0. A slow step delays
+// those after it, which are then taken together to catch up.
+void sm::worker::start(std::function<bool()> step, std::function<void()> publish, const int stepsPerSecond) {
+    stop();
+    stopping = false;
+    done = false;
+    rate = stepsPerSecond;
+    thread = std::thread([this, step = std::move(step), publish = std::move(publish)]() {
+        // The rate steps are being taken at, and when it was set. The steps due are counted from then.
+        int currentRate = rate;
+        auto begin = simulationClock::now();
+        auto lastPublished = begin;
+        long long stepCount = 0;
+        bool running = true;
+        while (running && !stopping) {
+            if (rate != currentRate) {
+                currentRate = rate;
+                begin = simulationClock::now();
+                stepCount = 0;
+            }
+            if (currentRate <= 0) {
+                running = step();
+                stepCount++;
+                if (stepCount % STEPS_PER_CLOCK_CHECK == 0 &&
+                    simulationClock::now() - lastPublished >= PUBLISH_INTERVAL) {
+                    publish();
+                    lastPublished = simulationClock::now();
+                }
+                continue;
+            }
+
+            // Take every step due by now, then publish them together and sleep until the next is due
+            const std::chrono::duration<double> elapsed = simulationClock::now() - begin;
+            const long long due = (long long)(elapsed.count() * currentRate) + 1;
+            while (running && stepCount < due && !stopping) {
+                running = step();
+                stepCount++;
+            }
+            publish();
+            const auto nextStep = begin + std::chrono::duration<double>((double)stepCount / currentRate);
+            const auto sleep = std::chrono::duration_cast<simulationClock::duration>(nextStep - simulationClock::now());
+            if (running && sleep.count() > 0) {
+                std::this_thread::sleep_for(std::min<simulationClock::duration>(sleep, LONGEST_SLEEP));
+            }
+        }
+        publish();
+        done = true;
+    });
+}
+
+void sm::worker::stop() {
+    stopping = true;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
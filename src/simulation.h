@@ -0,0 +1,97 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+// Run an animation's simulation on a thread of its own, so that it isn't held to one step per frame, and can use a core
+// of its own. The render thread never reads the simulation's state directly. Instead, the simulation records what each
+// step changes, and publishes those changes to the render thread through a double buffer, along with a snapshot of
+// anything else worth drawing, e.g. its queue length. The render thread applies them to its own copy of the state.
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace sm {
+
+// The status of a simulation whose changes say everything worth drawing
+struct noStatus {};
+
+// What the simulation has changed since the render thread last looked, and its status after the last of the changes
+template <typename Change, typename Status = noStatus>
+struct update {
+    std::vector<Change> changes;
+    Status status = {};
+};
+
+// Hands updates from the simulation thread to the render thread. The simulation records changes into the back buffer,
+// and publishes them every so often. The render thread takes whatever has been published since it last did, swapping
+// its own emptied buffer in for it. Changes published twice before they're taken are kept, rather than replaced, since
+// the render thread's copy of the state is only correct if it sees every one of them. The lock is held only for the
+// swap, so neither thread waits while the other works.
+template <typename Change, typename Status = noStatus>
+struct doubleBuffer {
+    // Only touched by the simulation thread
+    update<Change, Status> back;
+
+    // Record a change made by the simulation, to be published with the next call to publish
+    void record(const Change& change) { back.changes.push_back(change); }
+
+    void publish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fresh) {
+            front.changes.insert(front.changes.end(), back.changes.begin(), back.changes.end());
+            back.changes.clear();
+        } else {
+            // The front buffer was emptied by take, so it can be reused as the next back buffer
+            std::swap(front.changes, back.changes);
+        }
+        front.status = back.status;
+        fresh = true;
+    }
+
+    // Replace the contents of latest with what has been published since the last call. Returns false if nothing has,
+    // leaving latest with no changes and the status it had.
+    bool take(update<Change, Status>& latest) {
+        latest.changes.clear();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!fresh) {
+            return false;
+        }
+        std::swap(front.changes, latest.changes);
+        latest.status = front.status;
+        fresh = false;
+        return true;
+    }
+
+   private:
+    std::mutex mutex;
+    update<Change, Status> front;
+    // Whether front holds changes which haven't been taken yet
+    bool fresh = false;
+};
+
+// A thread which calls step until it returns false, to say the simulation has finished, or until stop is called.
+// Every so often, and after the last step, it calls publish, e.g. to publish a doubleBuffer. Both are only ever called
+// from the thread.
+struct worker {
+    void start(std::function<bool()> step, std::function<void()> publish, const int stepsPerSecond);
+    // Change the number of steps taken a second from now on, where 0 means as many as possible
+    void setRate(const int stepsPerSecond) { rate = stepsPerSecond; }
+    // Stop stepping, and wait for the thread to end. The simulation is left as it was after its last step.
+    void stop();
+    // Whether the simulation has finished, or been stopped, and published its last step
+    bool finished() const { return done; }
+    ~worker() { stop(); }
+
+   private:
+    std::thread thread;
+    std::atomic<bool> stopping = false;
+    std::atomic<bool> done = false;
+    std::atomic<int> rate = 0;
+};
+
+}  // namespace sm
+
+#endif /* SIMULATION_H */
@@ -0,0 +1,62 @@
+// Given a grid, find a shortest line between the defined start point and end point.
+// This solver is A*: the next cell to visit is the one with the lowest sum of the steps taken to reach it and a lower
+// bound on the steps left to the target. That bound is the Manhattan distance, or, given a landmark table for the
+// maze, the landmarks' lower bound on the distance, which is much tighter in a maze, so far fewer cells are visited.
+// Either way the bound never overestimates, so the path found is a shortest one.
+
+#include "a_star_solver.h"
+#include <stdexcept>
+#include "../../lib/raylib.h"
+#include "../constants.cpp"
+#include "../packed_path.h"
+#include "../utils.h"
+#include "frontier_solver.h"
+#include "landmarks.h"
+#include "solver_trace.h"
+
+using namespace constants;
+
+// The state of the most recent search
+static fs::search<fs::shortestFirstFrontier<lm::landmarkDistance>> g_search = {};
+
+// Throw if the landmark table in use doesn't belong to a maze of the grid's size
+static void checkLandmarks(const gridType& grid) {
+    const lm::landmarkTable* landmarks = g_search.frontier.heuristic.table;
+    if (landmarks != nullptr && (landmarks->rows != (int)grid.size() || landmarks->cols != (int)grid.at(0).size()))
+        throw std::invalid_argument("The landmark table was built for a maze of a different size");
+}
+
+// Given a valid maze, find a shortest path within that maze, connecting the start and end locations,
+// while respecting maze walls. Returns the path found, or an empty path if there is none.
+pp::packedPath as::solve(const gridType& grid, const XY& startLoc, const XY& endLoc) {
+    checkLandmarks(grid);
+    return g_search.solve(grid, startLoc, endLoc);
+}
+
+// Start a search, and return its visits one at a time, as they're made. The search doesn't record its visits, and
+// doesn't look for a path.
+sg::generator<st::stepEvent> as::steps(const gridType& grid, const XY& startLoc, const XY& endLoc) {
+    checkLandmarks(grid);
+    return g_search.steps(grid, startLoc, endLoc);
+}
+
+// Bound the steps left using the given landmark table, which must have been built for the maze being solved, from now
+// on. The table must outlive its use. Pass nullptr to go back to the Manhattan distance.
+void as::useLandmarks(const lm::landmarkTable* landmarks) {
+    g_search.frontier.heuristic.table = landmarks;
+}
+
+// Forget the results of any previous solve, so that the next call to solve starts afresh
+void as::reset() {
+    g_search.reset();
+}
+
+// Return the number of cells visited by the most recent solve
+int as::visitedCount() {
+    return st::size(g_search.trace);
+}
+
+// Animate the search, drawing each visit as it's made
+void as::animateSolution(const gridType& grid) {
+    fs::animate(g_search, grid, solverStart, solverEnd, false);
+}
@@ -0,0 +1,24 @@
+#ifndef A_STAR_SOLVER_H
+#define A_STAR_SOLVER_H
+
+#include "../../lib/raylib.h"
+#include "../packed_path.h"
+#include "../step_generator.h"
+#include "../utils.h"
+#include "landmarks.h"
+#include "solver_trace.h"
+
+using namespace utils;
+
+namespace as {
+
+void animateSolution(const gridType& grid);
+void reset();
+pp::packedPath solve(const gridType& grid, const XY& startLoc, const XY& endLoc);
+sg::generator<st::stepEvent> steps(const gridType& grid, const XY& startLoc, const XY& endLoc);
+void useLandmarks(const lm::landmarkTable* landmarks);
+int visitedCount();
+
+}  // namespace as
+
+#endif /* A_STAR_SOLVER_H */
@@ -0,0 +1,293 @@
+// Given a grid, find a contiguous line between the defined start point and end point by filling in dead ends.
+// A dead end is any cell, other than the start or end point, with at most one open side. Filling it (i.e. walling it
+// off from the rest of the maze) can turn its neighbor into a dead end, which is then filled in turn. In a perfect
+// maze, once no dead ends remain, the only cells left unfilled are those connecting the start and end points.
+// Filling happens in rounds. Every cell that is a dead end at the start of a round gets filled during that round,
+// independently of the others, so the work of each round can be split between threads.
+
+#include "dead_end_filler.h"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../../lib/raylib.h"
+#include "../constants.cpp"
+#include "../hud.h"
+#include "../pacing.h"
+#include "../render.h"
+#include "../utils.h"
+#include "../viewer.h"
+#include "../wall_layer.h"
+
+using namespace constants;
+using namespace utils;
+
+// The color used to mark cells that have been filled in
+static const Color FILLED_COLOR = {200, 200, 200, 255};
+// The color used to mark the cells left over once filling is complete
+static const Color SOLUTION_COLOR = {0, 158, 47, 155};
+
+// The absolute indices of the cells filled in each round, in the order the rounds happened.
+static std::vector<std::vector<int>> g_cellsFilledPerRound = {};
+
+static int roundCount() {
+    return g_cellsFilledPerRound.size();
+}
+
+// The cells left over after the most recent solve, in order from start to end.
+static pp::packedPath g_solutionPath = {};
+static bool g_solved = false;
+
+// The same, indexed by cell, so that drawing only needs to look at the cells on screen: the round in which each cell
+// was filled, or -1 if it never was, and whether it's on the solution
+static std::vector<int> g_roundOfCell = {};
+static std::vector<bool> g_onSolution = {};
+
+// Return the shortest path from start to end, only moving between connected cells. Empty if there's no such path.
+static pp::packedPath shortestPathWithin(const gridType& grid, const XY& start, const XY& end) {
+    const int cols = grid[0].size();
+    std::vector<int> parent(grid.size() * cols, -1);
+    std::deque<XY> locationsToCheck = {start};
+    parent[cellIndex(grid, start)] = cellIndex(grid, start);
+
+    while (!locationsToCheck.empty() && parent[cellIndex(grid, end)] == -1) {
+        const XY origin = locationsToCheck.front();
+        locationsToCheck.pop_front();
+        for (const int direction : DIRECTIONS) {
+            if (!isConnected(grid, origin, direction)) {
+                continue;
+            }
+            const XY neighbor = neighborOf(origin, direction);
+            if (parent[cellIndex(grid, neighbor)] == -1) {
+                parent[cellIndex(grid, neighbor)] = cellIndex(grid, origin);
+                locationsToCheck.push_back(neighbor);
+            }
+        }
+    }
+
+    if (parent[cellIndex(grid, end)] == -1) {
+        return pp::packedPath{};
+    }
+    // Follow the parents back from the end, then turn that path around
+    pp::packedPath backwards = pp::startingAt(end);
+    for (int idx = cellIndex(grid, end); idx != cellIndex(grid, start); idx = parent[idx]) {
+        pp::append(backwards, directionTo({idx % cols, idx / cols}, {parent[idx] % cols, parent[idx] / cols}));
+    }
+    return pp::reversed(backwards);
+}
+
+// Fill in dead ends until none remain, then return the leftover maze and the path through it. The input grid is
+// left untouched; filling happens on a copy.
+de::prunedMaze de::solve(const gridType& grid, const XY& startLoc, const XY& endLoc, const int threadCount) {
+    if (!inBounds(grid, startLoc))
+        throw std::invalid_argument("Start location out of grid bounds");
+    if (!inBounds(grid, endLoc))
+        throw std::invalid_argument("End location out of grid bounds");
+    if (threadCount < 1)
+        throw std::invalid_argument("At least one thread is required to fill dead ends");
+
+    const int rows = grid.size();
+    const int cols = grid[0].size();
+    const int startIdx = cellIndex(grid, startLoc);
+    const int endIdx = cellIndex(grid, endLoc);
+
+    // The number of sides of each cell that are open to a cell which hasn't been filled yet. These are decremented
+    // concurrently, whenever a neighbor gets filled.
+    std::vector<std::atomic<int>> openSides(rows * cols);
+    std::vector<std::atomic<bool>> filled(rows * cols);
+
+    // The worklist: dead ends to fill in the current round, plus the dead ends each thread found for the next round
+    std::vector<int> currentRound = {};
+    std::vector<std::vector<int>> nextRoundPerThread(threadCount);
+    g_cellsFilledPerRound.clear();
+
+    // Runs on a single thread, once every thread has finished its share of a round
+    auto onRoundComplete = [&]() noexcept {
+        if (!currentRound.empty()) {
+            g_cellsFilledPerRound.push_back(currentRound);
+        }
+        currentRound.clear();
+        for (auto& found : nextRoundPerThread) {
+            currentRound.insert(currentRound.end(), found.begin(), found.end());
+            found.clear();
+        }
+    };
+    std::barrier roundBarrier(threadCount, onRoundComplete);
+
+    // Fill the cell, and note any neighbor which becomes a dead end as a result. Exactly one thread sees a neighbor's
+    // open side count drop to 1, so each dead end is only found once.
+    auto fillCell = [&](const int idx, std::vector<int>& nextRound) {
+        filled[idx] = true;
+        const XY cell = {idx % cols, idx / cols};
+        for (const int direction : DIRECTIONS) {
+            if (!isConnected(grid, cell, direction)) {
+                continue;
+            }
+            const int neighborIdx = cellIndex(grid, neighborOf(cell, direction));
+            if (filled[neighborIdx]) {
+                continue;
+            }
+            const int remaining = openSides[neighborIdx].fetch_sub(1) - 1;
+            if (remaining == 1 && neighborIdx != startIdx && neighborIdx != endIdx) {
+                nextRound.push_back(neighborIdx);
+            }
+        }
+    };
+
+    auto worker = [&](const int threadIdx) {
+        // Count the open sides of this thread's share of the rows, and find the cells that start out as dead ends
+        for (int y = threadIdx; y < rows; y += threadCount) {
+            for (int x = 0; x < cols; x++) {
+                int sides = 0;
+                for (const int direction : DIRECTIONS) {
+                    sides += isConnected(grid, {x, y}, direction);
+                }
+                const int idx = y * cols + x;
+                openSides[idx] = sides;
+                if (sides <= 1 && idx != startIdx && idx != endIdx) {
+                    nextRoundPerThread[threadIdx].push_back(idx);
+                }
+            }
+        }
+        roundBarrier.arrive_and_wait();
+
+        // Every thread sees the same worklist here, so they all leave the loop during the same round
+        while (!currentRound.empty()) {
+            for (std::size_t i = threadIdx; i < currentRound.size(); i += threadCount) {
+                fillCell(currentRound[i], nextRoundPerThread[threadIdx]);
+            }
+            roundBarrier.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> threads = {};
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Only keep the connections between cells that survived
+    prunedMaze result = {createEmptyGrid(rows, cols), {}};
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            if (filled[y * cols + x]) {
+                continue;
+            }
+            for (const int direction : DIRECTIONS) {
+                if (isConnected(grid, {x, y}, direction) && !filled[cellIndex(grid, neighborOf({x, y}, direction))]) {
+                    result.grid[y][x] |= direction;
+                }
+            }
+        }
+    }
+
+    // In a perfect maze, the survivors form a single corridor. Otherwise loops may survive, so search for the path.
+    result.path = shortestPathWithin(result.grid, startLoc, endLoc);
+    if (result.path.length == 0) {
+        std::cerr << "Failed to find solution connecting points (" << startLoc.x << "," << startLoc.y << ") and ("
+                  << endLoc.x << "," << endLoc.y << ")" << std::endl;
+    }
+
+    g_solutionPath = result.path;
+    g_roundOfCell.assign(rows * cols, -1);
+    for (int round = 0; round < roundCount(); round++) {
+        for (const int idx : g_cellsFilledPerRound[round]) {
+            g_roundOfCell[idx] = round;
+        }
+    }
+    g_onSolution.assign(rows * cols, false);
+    for (const auto& cell : g_solutionPath) {
+        g_onSolution[cell.y * cols + cell.x] = true;
+    }
+    g_solved = true;
+    return result;
+}
+
+// Mark what the frame after the given number of rounds adds to the overview, which is drawn in place of the cells when
+// zoomed out: the last of those rounds, and the solution once every round is done
+static void markOverview(wl::wallLayer& walls, const int roundIdx) {
+    if (roundIdx > 0) {
+        for (const int idx : g_cellsFilledPerRound.at(roundIdx - 1)) {
+            ov::markVisited(walls.overview, {idx % walls.overview.cols, idx / walls.overview.cols});
+        }
+    }
+    if (roundIdx == roundCount()) {
+        for (const auto& cell : g_solutionPath) {
+            ov::markSolution(walls.overview, cell);
+        }
+    }
+}
+
+// Animate the filling of the maze's dead ends, filling as many rounds per frame as pacing asks for. If the maze has not
+// yet been solved, then this function solves it immediately.
+void de::animateSolution(const gridType& grid) {
+    if (!g_solved) {
+        de::solve(grid, solverStart, solverEnd, DEAD_END_FILLER_THREADS);
+    }
+
+    int roundIndex = 0;
+    auto walls = wl::load(grid, wallColor);
+    markOverview(walls, roundIndex);
+    pc::begin(g_cellsFilledPerRound.size(), FPS_SOLVING);
+    rd::setTargetFPS(FPS_SOLVING);
+    bool done = false;
+    while (!rd::shouldClose(done)) {
+        vw::update();
+        pc::update();
+        hd::update();
+        rd::beginFrame();
+        de::_solverDraw(grid, walls, roundIndex);
+        done = roundIndex >= roundCount();
+        if (!done) {
+            pc::advance([&]() {
+                roundIndex++;
+                markOverview(walls, roundIndex);
+                return roundIndex < roundCount();
+            });
+        }
+        // The cells filled so far
+        hd::draw(ov::visitedCount(walls.overview), (long long)grid.size() * grid.at(0).size());
+        rd::endFrame();
+    }
+    wl::unload(walls);
+    rd::close();
+}
+
+// This helper function draws the state of the maze after the given number of filling rounds. Once every round has
+// been drawn, the solution is drawn as well. It expects an open window or canvas.
+void de::_solverDraw(const gridType& grid, wl::wallLayer& walls, const int roundIdx) {
+    rd::clear(RAYWHITE);
+    const int cols = grid.at(0).size();
+
+    // The offsets are intended to stop these shapes from being drawn over the walls of the maze
+    rd::rectangle(solverEnd.x * CELLWIDTH, solverEnd.y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1,
+                  mazeEndpointColor);
+
+    // Earlier rounds are drawn as filled. The most recent round is highlighted. Once every round has been drawn, so
+    // is the solution.
+    const bool finished = roundIdx >= roundCount();
+    const vw::cellRange visible = vw::visibleCells(grid.size(), cols);
+    // Zoomed out, the wall layer draws the overview over the cells instead
+    const bool zoomedOut = vw::detailLevel() > 0;
+    for (int y = visible.minY; y < visible.maxY && !zoomedOut; y++) {
+        for (int x = visible.minX; x < visible.maxX; x++) {
+            const int round = g_roundOfCell[y * cols + x];
+            if (round >= 0 && round < roundIdx) {
+                const Color clr = (round == roundIdx - 1) ? cellFocusColor : FILLED_COLOR;
+                rd::rectangle(x * CELLWIDTH, y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1, clr);
+            } else if (finished && g_onSolution[y * cols + x]) {
+                rd::rectangle(x * CELLWIDTH, y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1, SOLUTION_COLOR);
+            }
+        }
+    }
+
+    wl::draw(walls);
+    rd::screenText(TextFormat("Round: %01i/%01i", roundIdx, roundCount()), 5, 5, 0, MAROON);
+}
@@ -0,0 +1,30 @@
+#ifndef DEAD_END_FILLER_H
+#define DEAD_END_FILLER_H
+
+#include <vector>
+#include "../../lib/raylib.h"
+#include "../packed_path.h"
+#include "../utils.h"
+#include "../wall_layer.h"
+
+using namespace utils;
+
+namespace de {
+
+// The result of filling every dead end in a maze.
+struct prunedMaze {
+    // A copy of the input maze in which every filled cell is walled off. Only the cells that survived filling remain
+    // connected, so later queries (by any solver) on this grid can't stray from the solution corridor.
+    gridType grid;
+    // The path through the surviving cells, from the start location to the end location. Empty if no path exists.
+    pp::packedPath path;
+};
+
+prunedMaze solve(const gridType& grid, const XY& startLoc, const XY& endLoc, const int threadCount = 1);
+void animateSolution(const gridType& grid);
+
+void _solverDraw(const gridType& grid, wl::wallLayer& walls, const int roundIdx);
+
+}  // namespace de
+
+#endif /* DEAD_END_FILLER_H */
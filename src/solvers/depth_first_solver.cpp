@@ -0,0 +1,43 @@
+// Given a grid, find a contiguous line between the defined start point and end point.
+// This solver searches depth first: it follows a corridor until it reaches a dead end, then backs up to the most
+// recently discovered cell it has not yet visited, and continues from there.
+
+#include "depth_first_solver.h"
+#include "../../lib/raylib.h"
+#include "../constants.cpp"
+#include "../packed_path.h"
+#include "../utils.h"
+#include "frontier_solver.h"
+#include "solver_trace.h"
+
+using namespace constants;
+
+// The state of the most recent search
+static fs::search<fs::lifoFrontier> g_search = {};
+
+// Given a valid maze, find a path within that maze, connecting the start and end locations,
+// while respecting maze walls. Returns the path found, or an empty path if there is none.
+pp::packedPath ds::solve(const gridType& grid, const XY& startLoc, const XY& endLoc) {
+    return g_search.solve(grid, startLoc, endLoc);
+}
+
+// Start a search, and return its visits one at a time, as they're made. The search doesn't record its visits, and
+// doesn't look for a path.
+sg::generator<st::stepEvent> ds::steps(const gridType& grid, const XY& startLoc, const XY& endLoc) {
+    return g_search.steps(grid, startLoc, endLoc);
+}
+
+// Forget the results of any previous solve, so that the next call to solve starts afresh
+void ds::reset() {
+    g_search.reset();
+}
+
+// Return the number of cells visited by the most recent solve
+int ds::visitedCount() {
+    return st::size(g_search.trace);
+}
+
+// Animate the search, drawing each visit as it's made
+void ds::animateSolution(const gridType& grid) {
+    fs::animate(g_search, grid, solverStart, solverEnd, false);
+}
@@ -0,0 +1,22 @@
+#ifndef DEPTH_FIRST_SOLVER_H
+#define DEPTH_FIRST_SOLVER_H
+
+#include "../../lib/raylib.h"
+#include "../packed_path.h"
+#include "../step_generator.h"
+#include "../utils.h"
+#include "solver_trace.h"
+
+using namespace utils;
+
+namespace ds {
+
+void animateSolution(const gridType& grid);
+void reset();
+pp::packedPath solve(const gridType& grid, const XY& startLoc, const XY& endLoc);
+sg::generator<st::stepEvent> steps(const gridType& grid, const XY& startLoc, const XY& endLoc);
+int visitedCount();
+
+}  // namespace ds
+
+#endif /* DEPTH_FIRST_SOLVER_H */
@@ -0,0 +1,227 @@
+// Compute the distance from every cell to one target, so that any number of start points can find their way there.
+// A single breadth first search outwards from the target visits each cell once, and notes the direction back towards
+// the cell it was reached from. Following those directions from any start cell walks the shortest path to the
+// target, without any further searching. Fields are cached per grid and target, so repeated lookups are free, until
+// some grid changes.
+
+#include "distance_field.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "../../lib/raylib.h"
+#include "../constants.cpp"
+#include "../hud.h"
+#include "../pacing.h"
+#include "../render.h"
+#include "../utils.h"
+#include "../viewer.h"
+#include "../wall_layer.h"
+
+using namespace constants;
+using namespace utils;
+
+// The colors of the cells closest to and furthest from the target, when drawing the heatmap
+static const Color HEAT_NEAR_COLOR = {230, 41, 55, 255};
+static const Color HEAT_FAR_COLOR = {255, 249, 196, 255};
+
+// A field computed by fieldFor, and the grid generation it was computed at
+struct cachedField {
+    unsigned long long generation;
+    std::shared_ptr<const df::distanceField> field;
+};
+
+// Fields computed by fieldFor, keyed by the grid's address and the target's absolute index
+static std::map<std::pair<const gridType*, int>, cachedField> g_cachedFields = {};
+static std::mutex g_cacheMutex;
+
+// Compute the distance field of the grid for the given target
+df::distanceField df::compute(const gridType& grid, const XY& target) {
+    distanceField field = {};
+    std::vector<int> locationsToCheck = {};
+    computeInto(field, locationsToCheck, grid, target);
+    return field;
+}
+
+// Compute the distance field of the grid for the given target into an existing field, reusing its storage and that of
+// locationsToCheck, which serves as the search's queue. If stopAt is in the grid, the search stops as soon as it's
+// reached, leaving the cells further from the target unreachable. Returns the number of cells checked.
+int df::computeInto(distanceField& field,
+                    std::vector<int>& locationsToCheck,
+                    const gridType& grid,
+                    const XY& target,
+                    const XY& stopAt) {
+    if (!inBounds(grid, target))
+        throw std::invalid_argument("Target location out of grid bounds");
+
+    field.target = target;
+    field.rows = grid.size();
+    field.cols = grid.at(0).size();
+    field.maxDistance = 0;
+    field.distance.assign(field.rows * field.cols, UNREACHABLE);
+    field.nextHop.assign(field.rows * field.cols, 0);
+    // A cell outside the grid is never reached, so the whole grid is searched
+    const bool stops = stopAt.x >= 0 && stopAt.y >= 0 && inBounds(grid, stopAt);
+    const int stopIdx = stops ? cellIndex(grid, stopAt) : 0;
+
+    // The cells are checked in order of distance, so a plain vector serves as the queue
+    locationsToCheck.clear();
+    locationsToCheck.reserve(field.rows * field.cols);
+    locationsToCheck.push_back(cellIndex(grid, target));
+    field.distance[locationsToCheck[0]] = 0;
+    std::size_t checked = 0;
+    while (checked < locationsToCheck.size() && !(stops && field.distance[stopIdx] != UNREACHABLE)) {
+        const int originIdx = locationsToCheck[checked++];
+        const XY origin = {originIdx % field.cols, originIdx / field.cols};
+        const std::uint32_t originDistance = field.distance[originIdx];
+        for (const int direction : DIRECTIONS) {
+            if (!isConnected(grid, origin, direction)) {
+                continue;
+            }
+            const int neighborIdx = cellIndex(grid, neighborOf(origin, direction));
+            if (field.distance[neighborIdx] == UNREACHABLE) {
+                field.distance[neighborIdx] = originDistance + 1;
+                field.maxDistance = originDistance + 1;
+                // The neighbor gets back here by going the opposite way
+                field.nextHop[neighborIdx] = oppositeOf(direction);
+                locationsToCheck.push_back(neighborIdx);
+            }
+        }
+    }
+    return checked;
+}
+
+// Return the distance field of the grid for the given target, computing it only if it isn't cached yet. A cached field
+// is only used if no grid has changed since it was computed, as counted by gridGeneration, and it matches the grid's
+// size. The field is shared, so it stays valid for as long as the caller holds it, even if the cache drops it.
+std::shared_ptr<const df::distanceField> df::fieldFor(const gridType& grid, const XY& target) {
+    if (!inBounds(grid, target))
+        throw std::invalid_argument("Target location out of grid bounds");
+
+    // Read before computing, so that a change made meanwhile makes the field stale rather than being missed
+    const unsigned long long generation = gridGeneration();
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    cachedField& cached = g_cachedFields[std::make_pair(&grid, cellIndex(grid, target))];
+    if (cached.field == nullptr || cached.generation != generation || cached.field->rows != (int)grid.size() ||
+        cached.field->cols != (int)grid.at(0).size()) {
+        cached = {generation, std::make_shared<const distanceField>(compute(grid, target))};
+    }
+    return cached.field;
+}
+
+// Forget every cached field
+void df::clearCache() {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_cachedFields.clear();
+}
+
+// Return the shortest path from the start location to the field's target. Empty if the target can't be reached.
+pp::packedPath df::pathFrom(const distanceField& field, const XY& start) {
+    pp::packedPath path = {};
+    pathInto(path, field, start);
+    return path;
+}
+
+// Write the shortest path from the start location to the field's target into an existing path, reusing its storage.
+// Its length is 0 if the target can't be reached.
+void df::pathInto(pp::packedPath& path, const distanceField& field, const XY& start) {
+    if (start.x < 0 || start.y < 0 || start.x >= field.cols || start.y >= field.rows)
+        throw std::invalid_argument("Start location out of grid bounds");
+
+    path.start = start;
+    path.steps.clear();
+    path.length = 0;
+    const std::uint32_t startDistance = field.distance[start.y * field.cols + start.x];
+    if (startDistance == UNREACHABLE) {
+        return;
+    }
+    path.length = 1;
+    path.steps.reserve(startDistance / 4 + 1);
+    for (XY current = start; !(current == field.target);) {
+        const int direction = field.nextHop[current.y * field.cols + current.x];
+        pp::append(path, direction);
+        current = neighborOf(current, direction);
+    }
+}
+
+// Draw the field as a heatmap, and walk the path from the start location to the end location along it, taking as many
+// steps per frame as pacing asks for.
+void df::animateSolution(const gridType& grid) {
+    const auto fieldPtr = fieldFor(grid, solverEnd);
+    const distanceField& field = *fieldPtr;
+    const auto path = pathFrom(field, solverStart);
+
+    auto walker = pp::begin(path);
+    auto walls = wl::load(grid, wallColor);
+    pc::begin(path.length, FPS_SOLVING);
+    rd::setTargetFPS(FPS_SOLVING);
+    bool done = false;
+    while (!rd::shouldClose(done)) {
+        vw::update();
+        pc::update();
+        hd::update();
+        rd::beginFrame();
+        if (walker != pp::end(path)) {
+            // The overview, drawn in place of the cells when zoomed out, shows the path walked so far
+            ov::markSolution(walls.overview, *walker);
+        }
+        df::_solverDraw(walls, field, path, walker);
+        done = walker.idx >= path.length - 1;
+        if (!done) {
+            pc::advance([&]() {
+                walker++;
+                ov::markSolution(walls.overview, *walker);
+                return walker.idx < path.length - 1;
+            });
+        }
+        // The walker only visits the cells on its path
+        hd::draw(walker.idx + 1, (long long)field.rows * field.cols);
+        rd::endFrame();
+    }
+    wl::unload(walls);
+    rd::close();
+}
+
+// Color each cell by its distance from the target. Unreachable cells are left blank. Expects an open window or canvas.
+void df::_drawHeatmap(const distanceField& field) {
+    const vw::cellRange visible = vw::visibleCells(field.rows, field.cols);
+    // Zoomed out, the wall layer draws the overview over the cells instead
+    const bool zoomedOut = vw::detailLevel() > 0;
+    for (int y = visible.minY; y < visible.maxY && !zoomedOut; y++) {
+        for (int x = visible.minX; x < visible.maxX; x++) {
+            const std::uint32_t distance = field.distance[y * field.cols + x];
+            if (distance == UNREACHABLE) {
+                continue;
+            }
+            // gradateColor returns the start color for the maximum index, so count down from the furthest cell
+            Color clr = HEAT_NEAR_COLOR;
+            if (field.maxDistance > 0) {
+                clr = utils::gradateColor(HEAT_NEAR_COLOR, HEAT_FAR_COLOR, field.maxDistance - distance,
+                                          field.maxDistance);
+            }
+            rd::rectangle(x * CELLWIDTH, y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1, clr);
+        }
+    }
+}
+
+// This helper function draws the heatmap and the walker's progress along its path. It expects an open window or canvas.
+void df::_solverDraw(wl::wallLayer& walls,
+                     const distanceField& field,
+                     const pp::packedPath& path,
+                     const pp::cellIterator& walker) {
+    rd::clear(RAYWHITE);
+    _drawHeatmap(field);
+
+    // The offsets are intended to stop these shapes from being drawn over the walls of the maze
+    if (walker != pp::end(path)) {
+        rd::rectangle(walker->x * CELLWIDTH, walker->y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1, cellFocusColor);
+    }
+
+    wl::draw(walls);
+    if (walker != pp::end(path)) {
+        const int distance = field.distance[walker->y * field.cols + walker->x];
+        rd::screenText(TextFormat("Distance: %01i", distance), 5, 5, 0, MAROON);
+    }
+}
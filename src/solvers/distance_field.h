@@ -0,0 +1,53 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../../lib/raylib.h"
+#include "../packed_path.h"
+#include "../utils.h"
+#include "../wall_layer.h"
+
+using namespace utils;
+
+namespace df {
+
+// The distance of cells from which the target can't be reached
+inline constexpr std::uint32_t UNREACHABLE = UINT32_MAX;
+
+// The distance from every cell of a maze to a single target, and the first step to take from each cell to get there
+struct distanceField {
+    XY target;
+    int rows;
+    int cols;
+    // The distance of the reachable cell furthest from the target
+    std::uint32_t maxDistance;
+    // The number of steps from each cell to the target, indexed by absolute index
+    std::vector<std::uint32_t> distance;
+    // The direction of the first step from each cell towards the target. 0 for the target itself, and for cells
+    // which can't reach it.
+    std::vector<std::uint8_t> nextHop;
+};
+
+distanceField compute(const gridType& grid, const XY& target);
+int computeInto(distanceField& field,
+                std::vector<int>& locationsToCheck,
+                const gridType& grid,
+                const XY& target,
+                const XY& stopAt = {-1, -1});
+std::shared_ptr<const distanceField> fieldFor(const gridType& grid, const XY& target);
+void clearCache();
+pp::packedPath pathFrom(const distanceField& field, const XY& start);
+void pathInto(pp::packedPath& path, const distanceField& field, const XY& start);
+void animateSolution(const gridType& grid);
+
+void _drawHeatmap(const distanceField& field);
+void _solverDraw(wl::wallLayer& walls,
+                 const distanceField& field,
+                 const pp::packedPath& path,
+                 const pp::cellIterator& walker);
+
+}  // namespace df
+
+#endif /* DISTANCE_FIELD_H */
@@ -0,0 +1,355 @@
+#ifndef FRONTIER_SOLVER_H
+#define FRONTIER_SOLVER_H
+
+// A search over the cells of a maze, parameterised by the order in which it visits the cells it has discovered.
+// The frontier is a template parameter rather than a base class, so that each kind of search compiles to its own loop,
+// with the frontier's push and pop inlined into it. Every search records its visits into the same kind of trace, so
+// they can all be animated the same way.
+//
+// A search can either be run to completion with solve, or stepped through lazily with steps, which yields one visit
+// at a time and records nothing. The animation pulls visits from steps as it needs them, so the first frame is drawn
+// without waiting for the whole maze to be solved.
+//
+// A frontier provides push(cell, target), pop(), size(), empty() and clear(). Cells may be pushed more than once; the
+// search skips any cell it has already visited when it's popped.
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+#include "../constants.cpp"
+#include "../hud.h"
+#include "../log.h"
+#include "../../lib/raylib.h"
+#include "../pacing.h"
+#include "../packed_path.h"
+#include "../render.h"
+#include "../simulation.h"
+#include "../step_generator.h"
+#include "../utils.h"
+#include "../viewer.h"
+#include "heuristics.h"
+#include "solver_trace.h"
+
+using namespace utils;
+
+namespace fs {
+
+// Visit cells in the order they were discovered: breadth first
+struct fifoFrontier {
+    std::deque<XY> cells;
+
+    void push(const XY& cell, const XY& /*target*/) { cells.push_back(cell); }
+    XY pop() {
+        const XY cell = cells.front();
+        cells.pop_front();
+        return cell;
+    }
+    std::size_t size() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+    void clear() { cells.clear(); }
+};
+
+// Visit the most recently discovered cell first: depth first
+struct lifoFrontier {
+    std::vector<XY> cells;
+
+    void push(const XY& cell, const XY& /*target*/) { cells.push_back(cell); }
+    XY pop() {
+        const XY cell = cells.back();
+        cells.pop_back();
+        return cell;
+    }
+    std::size_t size() const { return cells.size(); }
+    bool empty() const { return cells.empty(); }
+    void clear() { cells.clear(); }
+};
+
+// Visit the cell which the heuristic scores lowest first: best first. Of cells with equal scores, the one discovered
+// first is visited first.
+template <typename Heuristic>
+struct priorityFrontier {
+    struct entry {
+        int score;
+        long long order;
+        XY cell;
+        bool operator>(const entry& rhs) const {
+            return score != rhs.score ? score > rhs.score : order > rhs.order;
+        }
+    };
+
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> entries;
+    Heuristic heuristic;
+    long long pushed = 0;
+
+    void push(const XY& cell, const XY& target) { entries.push({heuristic(cell, target), pushed++, cell}); }
+    XY pop() {
+        const XY cell = entries.top().cell;
+        entries.pop();
+        return cell;
+    }
+    std::size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    void clear() {
+        entries = {};
+        pushed = 0;
+    }
+};
+
+// Visit the cell with the lowest sum of the steps taken to reach it and the heuristic's estimate of the steps left
+// first: A*. The search pushes a cell's neighbors straight after popping it, so each is one step further from the start
+// than the cell popped last. With a consistent heuristic, i.e. one which never drops by more than one between
+// neighbors, each cell is first popped via a shortest path to it, and the path found is a shortest one.
+template <typename Heuristic>
+struct shortestFirstFrontier {
+    struct entry {
+        int score;
+        int steps;
+        long long order;
+        XY cell;
+        // Of cells with equal scores, the one nearest the start is visited first, then the one discovered first. Cells
+        // are then visited in order of score and steps, so every cell's earliest visited neighbor is one step nearer
+        // the start, and tracing back through earliest visited neighbors follows a shortest path.
+        bool operator>(const entry& rhs) const {
+            if (score != rhs.score)
+                return score > rhs.score;
+            return steps != rhs.steps ? steps > rhs.steps : order > rhs.order;
+        }
+    };
+
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> entries;
+    Heuristic heuristic;
+    long long pushed = 0;
+    // The steps taken to reach the cell popped last, or -1 before the start has been popped
+    int lastSteps = -1;
+
+    void push(const XY& cell, const XY& target) {
+        entries.push({lastSteps + 1 + heuristic(cell, target), lastSteps + 1, pushed++, cell});
+    }
+    XY pop() {
+        const entry top = entries.top();
+        entries.pop();
+        lastSteps = top.steps;
+        return top.cell;
+    }
+    std::size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    void clear() {
+        entries = {};
+        pushed = 0;
+        lastSteps = -1;
+    }
+};
+
+// The state of one search, which can be advanced a step at a time
+template <typename Frontier>
+struct search {
+    const gridType* grid = nullptr;
+    XY start = {0, 0};
+    XY target = {0, 0};
+    Frontier frontier = {};
+    // Indexed by cellIndex
+    std::vector<bool> visited = {};
+    st::solveTrace trace = {};
+    bool found = false;
+
+    // Forget any previous search, keeping the storage for the next one
+    void reset() {
+        grid = nullptr;
+        frontier.clear();
+        visited.clear();
+        st::clear(trace);
+        found = false;
+    }
+
+    // Prepare to search the given grid. Throws if either location is outside of it.
+    void begin(const gridType& maze, const XY& startLoc, const XY& endLoc) {
+        if (!inBounds(maze, startLoc))
+            throw std::invalid_argument("Start location out of grid bounds");
+        if (!inBounds(maze, endLoc))
+            throw std::invalid_argument("End location out of grid bounds");
+
+        reset();
+        grid = &maze;
+        start = startLoc;
+        target = endLoc;
+        visited.assign(maze.size() * maze.at(0).size(), false);
+        frontier.push(startLoc, endLoc);
+    }
+
+    // Perform the next step of the search: visit the next unvisited cell from the frontier, and add its unvisited
+    // neighbors to the frontier. Returns false, without visiting anything, once there is nothing left to do, either
+    // because the target was found or because every reachable cell has been visited.
+    bool nextStep(st::stepEvent& visit) {
+        while (!found && !frontier.empty()) {
+            const int taskCount = frontier.size();
+            const XY origin = frontier.pop();
+            const int originIdx = cellIndex(*grid, origin);
+            if (visited[originIdx]) {
+                continue;
+            }
+            visited[originIdx] = true;
+            visit = {origin, taskCount};
+            MAZE_LOG(LEVEL_TRACE, LOG_SOLVER,
+                     "visiting (" << origin.x << ',' << origin.y << "), " << taskCount - 1
+                                  << " cells left in the frontier");
+
+            if (origin == target) {
+                MAZE_LOG(LEVEL_INFO, LOG_SOLVER, "FOUND target at " << origin.x << ',' << origin.y);
+                // The search is over, so what it logged needn't wait for the buffer to fill
+                lg::flush();
+                visit.taskCount = 0;
+                found = true;
+                return true;
+            }
+
+            for (const int direction : constants::DIRECTIONS) {
+                if (!isConnected(*grid, origin, direction)) {
+                    continue;
+                }
+                const XY neighbor = neighborOf(origin, direction);
+                if (!visited[cellIndex(*grid, neighbor)]) {
+                    frontier.push(neighbor, target);
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Start a search from the start to the end location, and return its visits one at a time, as they're made. Nothing
+    // is recorded in the trace. Throws straight away if either location is out of bounds.
+    sg::generator<st::stepEvent> steps(const gridType& maze, const XY& startLoc, const XY& endLoc) {
+        begin(maze, startLoc, endLoc);
+        return _walk();
+    }
+
+    // Search from the start to the end location. Returns the path found, or an empty path if there is none.
+    pp::packedPath solve(const gridType& maze, const XY& startLoc, const XY& endLoc) {
+        begin(maze, startLoc, endLoc);
+        st::stepEvent visit;
+        while (nextStep(visit)) {
+            st::recordVisit(trace, visit.cell, visit.taskCount);
+        }
+        if (!found) {
+            std::cerr << "Failed to find solution connecting points (" << startLoc.x << "," << startLoc.y << ") and ("
+                      << endLoc.x << "," << endLoc.y << ")" << std::endl;
+            return pp::packedPath{};
+        }
+        std::vector<int> visitOrder(maze.size() * maze.at(0).size(), -1);
+        st::forEachVisit(trace, st::size(trace), [&](const std::size_t stepIdx, const st::stepEvent& visit) {
+            visitOrder[cellIndex(maze, visit.cell)] = stepIdx;
+        });
+        return pp::traceBack(maze, visitOrder, endLoc, startLoc);
+    }
+
+    sg::generator<st::stepEvent> _walk() {
+        st::stepEvent visit;
+        while (nextStep(visit)) {
+            co_yield visit;
+        }
+    }
+};
+
+// Search on a thread of its own, at SOLVING_STEPS_PER_SECOND or as fast as pacing asks for, while this one draws the
+// visits made so far at the display's rate. Every visit made since the last frame is added to the view before it's
+// drawn.
+template <typename Frontier>
+void _animateFromSimulationThread(search<Frontier>& solver, const gridType& grid, const XY& startLoc,
+                                  const XY& endLoc, const bool drawScores) {
+    solver.begin(grid, startLoc, endLoc);
+    auto view = st::_openTraceView(grid);
+    pc::begin((long long)grid.size() * grid.at(0).size(), constants::FPS_DISPLAY);
+    sm::doubleBuffer<st::stepEvent> updates;
+    sm::update<st::stepEvent> latest;
+    sm::worker simulation;
+    simulation.start(
+        [&]() {
+            st::stepEvent visit;
+            if (!solver.nextStep(visit)) {
+                return false;
+            }
+            st::recordVisit(solver.trace, visit.cell, visit.taskCount);
+            updates.record(visit);
+            return true;
+        },
+        [&]() { updates.publish(); }, pc::stepsPerSecond(constants::SOLVING_STEPS_PER_SECOND));
+
+    rd::setTargetFPS(constants::FPS_DISPLAY);
+    bool done = false;
+    while (!rd::shouldClose(done)) {
+        vw::update();
+        pc::update();
+        hd::update();
+        simulation.setRate(pc::stepsPerSecond(constants::SOLVING_STEPS_PER_SECOND));
+        // Once the search has finished, its last visits are taken below, so this frame shows where it ended
+        done = simulation.finished();
+        const auto applyStart = std::chrono::steady_clock::now();
+        updates.take(latest);
+        for (const st::stepEvent& visit : latest.changes) {
+            st::_traceVisit(view, visit);
+        }
+        hd::recordSimulation(applyStart, latest.changes.size());
+        rd::beginFrame();
+        if (view.visitCount > 0) {
+            st::_traceFrame(view, endLoc, drawScores);
+        }
+        hd::draw(view.visitCount, (long long)view.rows * view.cols);
+        rd::endFrame();
+    }
+    simulation.stop();
+    st::_closeTraceView(view);
+}
+
+// Animate a search from the start to the end location, recording its visits into the search's trace. With a window
+// and SIMULATION_THREAD set, the search runs on a thread of its own; otherwise, pacing decides how many visits each
+// frame makes, and the frame is drawn as of the last of them.
+// Expects an open window or canvas. If drawScores is set, every cell is labelled with its Manhattan distance to the end
+// location.
+template <typename Frontier>
+void animate(search<Frontier>& solver, const gridType& grid, const XY& startLoc, const XY& endLoc,
+             const bool drawScores) {
+    if (constants::SIMULATION_THREAD && !rd::isHeadless()) {
+        _animateFromSimulationThread(solver, grid, startLoc, endLoc, drawScores);
+        rd::close();
+        return;
+    }
+    auto visits = solver.steps(grid, startLoc, endLoc);
+    auto nextVisit = visits.begin();
+    auto view = st::_openTraceView(grid);
+    // A search visits each cell at most once
+    pc::begin((long long)grid.size() * grid.at(0).size(), constants::FPS_SOLVING);
+    rd::setTargetFPS(constants::FPS_SOLVING);
+    bool done = false;
+    while (!rd::shouldClose(done)) {
+        vw::update();
+        pc::update();
+        hd::update();
+        rd::beginFrame();
+        pc::advance([&]() {
+            if (nextVisit == visits.end()) {
+                return false;
+            }
+            const st::stepEvent visit = *nextVisit;
+            st::recordVisit(solver.trace, visit.cell, visit.taskCount);
+            st::_traceVisit(view, visit);
+            ++nextVisit;
+            return nextVisit != visits.end();
+        });
+        if (view.visitCount > 0) {
+            st::_traceFrame(view, endLoc, drawScores);
+        }
+        hd::draw(view.visitCount, (long long)view.rows * view.cols);
+        done = nextVisit == visits.end();
+        rd::endFrame();
+    }
+    st::_closeTraceView(view);
+    rd::close();
+}
+
+}  // namespace fs
+
+#endif /* FRONTIER_SOLVER_H */
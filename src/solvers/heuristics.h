@@ -0,0 +1,21 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+// Estimates of the number of steps between two cells, for the searches which visit the most promising cells first.
+// Kept apart from the searches themselves, so that solvers which never draw can use them without the drawing code.
+
+#include <cstdlib>
+#include "../utils.h"
+
+namespace fs {
+
+// The sum of the absolute differences between the coordinates of the cell and the target
+struct manhattanDistance {
+    int operator()(const utils::XY& cell, const utils::XY& target) const {
+        return std::abs(target.x - cell.x) + std::abs(target.y - cell.y);
+    }
+};
+
+}  // namespace fs
+
+#endif /* HEURISTICS_H */
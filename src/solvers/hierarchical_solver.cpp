@@ -0,0 +1,328 @@
+// Find paths through very large mazes with hierarchical pathfinding (HPA*).
+// Building the abstract graph does the expensive work once per maze: every cluster is searched from each of its
+// entrances, and those searches don't depend on each other, so clusters are shared out between threads. A query then
+// only searches the clusters its start and end locations lie in, plus the (small) abstract graph in between. Finally,
+// the abstract path is refined into cells, searching only the clusters the path passes through.
+
+#include "hierarchical_solver.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../constants.cpp"
+#include "../utils.h"
+
+using namespace constants;
+using namespace utils;
+
+// A breadth first search confined to one cluster. Buffers are indexed relative to the cluster's top left cell.
+struct clusterSearch {
+    int x0;
+    int y0;
+    int width;
+    int height;
+    std::vector<int> distance;
+    std::vector<int> parent;
+};
+
+// Return the index of the cluster containing the cell
+static int clusterOf(const hp::abstractGraph& graph, const XY& cell) {
+    return (cell.y / graph.clusterSize) * graph.clustersX + cell.x / graph.clusterSize;
+}
+
+// Point the search at the given cluster, resizing its buffers if necessary
+static void prepareSearch(const hp::abstractGraph& graph, const int cluster, clusterSearch& search) {
+    search.x0 = (cluster % graph.clustersX) * graph.clusterSize;
+    search.y0 = (cluster / graph.clustersX) * graph.clusterSize;
+    search.width = std::min(graph.clusterSize, graph.cols - search.x0);
+    search.height = std::min(graph.clusterSize, graph.rows - search.y0);
+    search.distance.resize(search.width * search.height);
+    search.parent.resize(search.width * search.height);
+}
+
+// Search the cluster outwards from the given cell, which must lie within it, filling in distances and parents
+static void searchCluster(const gridType& grid, clusterSearch& search, const XY& from) {
+    std::fill(search.distance.begin(), search.distance.end(), -1);
+    auto localIndex = [&search](const XY& cell) { return (cell.y - search.y0) * search.width + (cell.x - search.x0); };
+
+    std::vector<XY> locationsToCheck = {from};
+    search.distance[localIndex(from)] = 0;
+    for (std::size_t i = 0; i < locationsToCheck.size(); i++) {
+        const XY origin = locationsToCheck[i];
+        for (const int direction : DIRECTIONS) {
+            const XY neighbor = neighborOf(origin, direction);
+            const bool inCluster = neighbor.x >= search.x0 && neighbor.y >= search.y0 &&
+                                   neighbor.x < search.x0 + search.width && neighbor.y < search.y0 + search.height;
+            if (!inCluster || search.distance[localIndex(neighbor)] != -1 || !isConnected(grid, origin, direction)) {
+                continue;
+            }
+            search.distance[localIndex(neighbor)] = search.distance[localIndex(origin)] + 1;
+            search.parent[localIndex(neighbor)] = localIndex(origin);
+            locationsToCheck.push_back(neighbor);
+        }
+    }
+}
+
+// Append the path found by the most recent searchCluster call, from its start to the given cell
+static void appendClusterPath(const clusterSearch& search, const XY& to, pp::packedPath& path) {
+    // The search's parents lead back towards its start, so walk them from the given cell and append that in reverse
+    pp::packedPath backwards = pp::startingAt(to);
+    for (int local = (to.y - search.y0) * search.width + (to.x - search.x0); search.distance[local] != 0;
+         local = search.parent[local]) {
+        const int parent = search.parent[local];
+        pp::append(backwards, directionTo({search.x0 + local % search.width, search.y0 + local / search.width},
+                                          {search.x0 + parent % search.width, search.y0 + parent / search.width}));
+    }
+    pp::appendPath(path, pp::reversed(backwards));
+}
+
+// Build the abstract graph of the grid, sharing the per-cluster searches between the given number of threads
+hp::abstractGraph hp::build(const gridType& grid, const int clusterSize, const int threadCount) {
+    if (clusterSize < 1)
+        throw std::invalid_argument("Clusters must be at least one cell wide");
+    if (threadCount < 1)
+        throw std::invalid_argument("At least one thread is required to build the abstract graph");
+
+    abstractGraph graph = {};
+    graph.rows = grid.size();
+    graph.cols = grid.at(0).size();
+    graph.clusterSize = clusterSize;
+    graph.clustersX = (graph.cols + clusterSize - 1) / clusterSize;
+    graph.clustersY = (graph.rows + clusterSize - 1) / clusterSize;
+    const int clusterCount = graph.clustersX * graph.clustersY;
+
+    // The node number of each entrance cell. Other cells aren't in the map.
+    std::unordered_map<int, int> cellToNode = {};
+    auto nodeFor = [&graph, &cellToNode](const XY& cell) {
+        const int idx = cell.y * graph.cols + cell.x;
+        const auto [entry, inserted] = cellToNode.try_emplace(idx, (int)graph.nodeCells.size());
+        if (inserted) {
+            graph.nodeCells.push_back(idx);
+        }
+        return entry->second;
+    };
+
+    // Find the entrances, i.e. the passages crossing cluster borders. Each passage is an edge of length 1.
+    std::vector<std::vector<std::pair<int, int>>> adjacency = {};
+    auto addPassage = [&](const XY& from, const int direction) {
+        const int a = nodeFor(from);
+        const int b = nodeFor(neighborOf(from, direction));
+        adjacency.resize(graph.nodeCells.size());
+        adjacency[a].push_back({b, 1});
+        adjacency[b].push_back({a, 1});
+    };
+    for (int x = clusterSize - 1; x + 1 < graph.cols; x += clusterSize) {
+        for (int y = 0; y < graph.rows; y++) {
+            if (isConnected(grid, {x, y}, EAST)) {
+                addPassage({x, y}, EAST);
+            }
+        }
+    }
+    for (int y = clusterSize - 1; y + 1 < graph.rows; y += clusterSize) {
+        for (int x = 0; x < graph.cols; x++) {
+            if (isConnected(grid, {x, y}, SOUTH)) {
+                addPassage({x, y}, SOUTH);
+            }
+        }
+    }
+    adjacency.resize(graph.nodeCells.size());
+
+    // Group the nodes by cluster
+    std::vector<int> clusterSizes(clusterCount + 1, 0);
+    for (const int cell : graph.nodeCells) {
+        clusterSizes[clusterOf(graph, {cell % graph.cols, cell / graph.cols}) + 1]++;
+    }
+    graph.clusterNodeOffsets.assign(clusterCount + 1, 0);
+    for (int c = 0; c < clusterCount; c++) {
+        graph.clusterNodeOffsets[c + 1] = graph.clusterNodeOffsets[c] + clusterSizes[c + 1];
+    }
+    graph.clusterNodes.resize(graph.nodeCells.size());
+    std::vector<int> nextSlot(graph.clusterNodeOffsets.begin(), graph.clusterNodeOffsets.end() - 1);
+    for (int node = 0; node < (int)graph.nodeCells.size(); node++) {
+        const int cell = graph.nodeCells[node];
+        graph.clusterNodes[nextSlot[clusterOf(graph, {cell % graph.cols, cell / graph.cols})]++] = node;
+    }
+
+    // Connect the nodes within each cluster. Each thread handles every threadCount'th cluster, and only writes to the
+    // edge lists of its own clusters.
+    std::vector<std::vector<std::tuple<int, int, int>>> intraClusterEdges(clusterCount);
+    auto worker = [&](const int threadIdx) {
+        clusterSearch search = {};
+        for (int cluster = threadIdx; cluster < clusterCount; cluster += threadCount) {
+            const int first = graph.clusterNodeOffsets[cluster];
+            const int last = graph.clusterNodeOffsets[cluster + 1];
+            if (last - first < 2) {
+                continue;
+            }
+            prepareSearch(graph, cluster, search);
+            for (int i = first; i < last; i++) {
+                const int from = graph.clusterNodes[i];
+                searchCluster(grid, search, {graph.nodeCells[from] % graph.cols, graph.nodeCells[from] / graph.cols});
+                for (int j = first; j < last; j++) {
+                    const int to = graph.clusterNodes[j];
+                    const XY toCell = {graph.nodeCells[to] % graph.cols, graph.nodeCells[to] / graph.cols};
+                    const int distance = search.distance[(toCell.y - search.y0) * search.width + toCell.x - search.x0];
+                    if (to != from && distance > 0) {
+                        intraClusterEdges[cluster].push_back({from, to, distance});
+                    }
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads = {};
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& edges : intraClusterEdges) {
+        for (const auto& [from, to, length] : edges) {
+            adjacency[from].push_back({to, length});
+        }
+    }
+    graph.edgeOffsets.push_back(0);
+    for (const auto& edges : adjacency) {
+        for (const auto& [to, length] : edges) {
+            graph.edgeTargets.push_back(to);
+            graph.edgeLengths.push_back(length);
+        }
+        graph.edgeOffsets.push_back(graph.edgeTargets.size());
+    }
+    return graph;
+}
+
+// Find the shortest path between the start and end locations. The grid must be the one the graph was built from.
+hp::queryResult hp::solve(const abstractGraph& graph, const gridType& grid, const XY& startLoc, const XY& endLoc) {
+    if (!inBounds(grid, startLoc))
+        throw std::invalid_argument("Start location out of grid bounds");
+    if (!inBounds(grid, endLoc))
+        throw std::invalid_argument("End location out of grid bounds");
+
+    queryResult result = {};
+    const int startCluster = clusterOf(graph, startLoc);
+    const int endCluster = clusterOf(graph, endLoc);
+    auto nodeCell = [&graph](const int node) {
+        return XY{graph.nodeCells[node] % graph.cols, graph.nodeCells[node] / graph.cols};
+    };
+    auto localDistance = [](const clusterSearch& search, const XY& cell) {
+        return search.distance[(cell.y - search.y0) * search.width + cell.x - search.x0];
+    };
+
+    // Connect the start and end locations to the entrances of their clusters
+    clusterSearch startSearch = {};
+    clusterSearch endSearch = {};
+    prepareSearch(graph, startCluster, startSearch);
+    searchCluster(grid, startSearch, startLoc);
+    prepareSearch(graph, endCluster, endSearch);
+    searchCluster(grid, endSearch, endLoc);
+
+    // The path may stay within a single cluster
+    int bestLength = INT_MAX;
+    if (startCluster == endCluster && localDistance(startSearch, endLoc) != -1) {
+        bestLength = localDistance(startSearch, endLoc);
+    }
+
+    // A* over the abstract graph, with the Manhattan distance to the end location as the heuristic
+    const int nodeCount = graph.nodeCells.size();
+    std::vector<int> distance(nodeCount, INT_MAX);
+    std::vector<int> parent(nodeCount, -1);
+    auto heuristic = [&](const int node) {
+        const XY cell = nodeCell(node);
+        return std::abs(cell.x - endLoc.x) + std::abs(cell.y - endLoc.y);
+    };
+    typedef std::pair<int, int> scoreAndNode;
+    std::priority_queue<scoreAndNode, std::vector<scoreAndNode>, std::greater<scoreAndNode>> frontier;
+    for (int i = graph.clusterNodeOffsets[startCluster]; i < graph.clusterNodeOffsets[startCluster + 1]; i++) {
+        const int node = graph.clusterNodes[i];
+        const int seedDistance = localDistance(startSearch, nodeCell(node));
+        if (seedDistance != -1) {
+            distance[node] = seedDistance;
+            frontier.push({seedDistance + heuristic(node), node});
+        }
+    }
+
+    int bestEndNode = -1;
+    while (!frontier.empty()) {
+        const auto [score, node] = frontier.top();
+        frontier.pop();
+        if (score >= bestLength) {
+            break;
+        }
+        if (score > distance[node] + heuristic(node)) {
+            // A shorter route to this node was already settled
+            continue;
+        }
+        result.nodesExpanded++;
+
+        if (clusterOf(graph, nodeCell(node)) == endCluster) {
+            const int exitDistance = localDistance(endSearch, nodeCell(node));
+            if (exitDistance != -1 && distance[node] + exitDistance < bestLength) {
+                bestLength = distance[node] + exitDistance;
+                bestEndNode = node;
+            }
+        }
+
+        for (int edge = graph.edgeOffsets[node]; edge < graph.edgeOffsets[node + 1]; edge++) {
+            const int target = graph.edgeTargets[edge];
+            const int targetDistance = distance[node] + graph.edgeLengths[edge];
+            if (targetDistance < distance[target]) {
+                distance[target] = targetDistance;
+                parent[target] = node;
+                frontier.push({targetDistance + heuristic(target), target});
+            }
+        }
+    }
+
+    if (bestLength == INT_MAX) {
+        return result;
+    }
+    result.path = pp::startingAt(startLoc);
+    if (bestEndNode == -1) {
+        // The path within the start cluster won
+        appendClusterPath(startSearch, endLoc, result.path);
+        return result;
+    }
+
+    // Refine the abstract path into cells. Consecutive nodes are either joined by a passage across a cluster border,
+    // or lie in the same cluster, which is then searched again.
+    std::vector<int> nodes = {};
+    for (int node = bestEndNode; node != -1; node = parent[node]) {
+        nodes.push_back(node);
+    }
+    std::reverse(nodes.begin(), nodes.end());
+
+    appendClusterPath(startSearch, nodeCell(nodes.front()), result.path);
+    clusterSearch refineSearch = {};
+    for (std::size_t i = 1; i < nodes.size(); i++) {
+        const XY from = nodeCell(nodes[i - 1]);
+        const XY to = nodeCell(nodes[i]);
+        if (clusterOf(graph, from) != clusterOf(graph, to)) {
+            pp::append(result.path, directionTo(from, to));
+            continue;
+        }
+        prepareSearch(graph, clusterOf(graph, from), refineSearch);
+        searchCluster(grid, refineSearch, from);
+        appendClusterPath(refineSearch, to, result.path);
+    }
+
+    // The end search ran from the end location, so walk its parents forwards from the last node
+    const XY lastNode = nodeCell(nodes.back());
+    for (int local = (lastNode.y - endSearch.y0) * endSearch.width + (lastNode.x - endSearch.x0);
+         endSearch.distance[local] != 0;) {
+        const XY from = {endSearch.x0 + local % endSearch.width, endSearch.y0 + local / endSearch.width};
+        local = endSearch.parent[local];
+        pp::append(result.path, directionTo(from, {endSearch.x0 + local % endSearch.width,
+                                                   endSearch.y0 + local / endSearch.width}));
+    }
+    return result;
+}
@@ -0,0 +1,45 @@
+#ifndef HIERARCHICAL_SOLVER_H
+#define HIERARCHICAL_SOLVER_H
+
+#include <vector>
+#include "../packed_path.h"
+#include "../utils.h"
+
+using namespace utils;
+
+namespace hp {
+
+// A coarse view of a maze, for hierarchical pathfinding (HPA*). The grid is split into square clusters. Wherever a
+// passage crosses the border between two clusters, the cells on either side of it become entrance nodes. Nodes are
+// connected to the nodes of neighboring clusters by their passage, and to the other nodes of their own cluster by the
+// shortest path within the cluster. Edges are stored in compressed sparse row form, like jg::junctionGraph's.
+struct abstractGraph {
+    int rows;
+    int cols;
+    int clusterSize;
+    // The number of clusters across and down the grid
+    int clustersX;
+    int clustersY;
+    // The absolute index of each node's cell
+    std::vector<int> nodeCells;
+    // The nodes in cluster c are clusterNodes[clusterNodeOffsets[c]] up to clusterNodes[clusterNodeOffsets[c + 1] - 1]
+    std::vector<int> clusterNodeOffsets;
+    std::vector<int> clusterNodes;
+    std::vector<int> edgeOffsets;
+    std::vector<int> edgeTargets;
+    std::vector<int> edgeLengths;
+};
+
+struct queryResult {
+    // The path from the start location to the end location. Empty if no path exists.
+    pp::packedPath path;
+    // How many abstract nodes were settled by the search
+    int nodesExpanded;
+};
+
+abstractGraph build(const gridType& grid, const int clusterSize, const int threadCount = 1);
+queryResult solve(const abstractGraph& graph, const gridType& grid, const XY& startLoc, const XY& endLoc);
+
+}  // namespace hp
+
+#endif /* HIERARCHICAL_SOLVER_H */
@@ -0,0 +1,189 @@
+// Keep a path between two points up to date while the maze's walls change, using D* Lite.
+// Re-solving from scratch after every edit repeats all of the work done before it. D* Lite instead keeps every cell's
+// distance to the goal from one call to the next. When a wall opens or closes, only the two cells on either side of it
+// are re-examined, and the correction spreads only as far as distances actually change.
+// Reference: S. Koenig and M. Likhachev, "D* Lite", AAAI 2002.
+
+#include "incremental_planner.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include "../constants.cpp"
+#include "../utils.h"
+
+using namespace constants;
+using namespace utils;
+
+static int manhattanDistance(const XY& a, const XY& b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+
+static XY cellAt(const ip::planner& plan, const int idx) {
+    return {idx % plan.cols, idx / plan.cols};
+}
+
+static std::pair<int, int> calculateKey(const ip::planner& plan, const int idx) {
+    const int best = std::min(plan.g[idx], plan.rhs[idx]);
+    return {best + manhattanDistance(plan.start, cellAt(plan, idx)) + plan.keyModifier, best};
+}
+
+static void dequeue(ip::planner& plan, const int idx) {
+    if (plan.queued[idx]) {
+        plan.open.erase({plan.queuedKey[idx].first, plan.queuedKey[idx].second, idx});
+        plan.queued[idx] = false;
+    }
+}
+
+static void enqueue(ip::planner& plan, const int idx) {
+    dequeue(plan, idx);
+    plan.queuedKey[idx] = calculateKey(plan, idx);
+    plan.open.insert({plan.queuedKey[idx].first, plan.queuedKey[idx].second, idx});
+    plan.queued[idx] = true;
+}
+
+// Recalculate the cell's rhs value from its neighbors, and queue it if it's now inconsistent
+static void updateVertex(ip::planner& plan, const int idx) {
+    const XY cell = cellAt(plan, idx);
+    if (!(cell == plan.goal)) {
+        int best = ip::UNREACHABLE;
+        for (const int direction : DIRECTIONS) {
+            if (isConnected(*plan.grid, cell, direction)) {
+                const int neighborIdx = cellIndex(*plan.grid, neighborOf(cell, direction));
+                best = std::min(best, plan.g[neighborIdx] + 1);
+            }
+        }
+        plan.rhs[idx] = std::min(best, ip::UNREACHABLE);
+    }
+
+    if (plan.g[idx] != plan.rhs[idx]) {
+        enqueue(plan, idx);
+    } else {
+        dequeue(plan, idx);
+    }
+}
+
+// Set up the planner for a new search. Call computeShortestPath to run it.
+void ip::initialize(planner& plan, const gridType& grid, const XY& startLoc, const XY& goalLoc) {
+    if (!inBounds(grid, startLoc))
+        throw std::invalid_argument("Start location out of grid bounds");
+    if (!inBounds(grid, goalLoc))
+        throw std::invalid_argument("Goal location out of grid bounds");
+
+    plan.grid = &grid;
+    plan.rows = grid.size();
+    plan.cols = grid.at(0).size();
+    plan.start = startLoc;
+    plan.goal = goalLoc;
+    plan.lastStart = startLoc;
+    plan.keyModifier = 0;
+    plan.g.assign(plan.rows * plan.cols, UNREACHABLE);
+    plan.rhs.assign(plan.rows * plan.cols, UNREACHABLE);
+    plan.open.clear();
+    plan.queuedKey.assign(plan.rows * plan.cols, {0, 0});
+    plan.queued.assign(plan.rows * plan.cols, false);
+    plan.listenerId = -1;
+    plan.expansions = 0;
+
+    const int goalIdx = cellIndex(grid, goalLoc);
+    plan.rhs[goalIdx] = 0;
+    enqueue(plan, goalIdx);
+}
+
+// Have the planner notified of every wall edit made through utils::setWall on its grid. The planner must not be moved
+// or destroyed while attached.
+void ip::attach(planner& plan) {
+    detach(plan);
+    plan.listenerId = addWallListener([&plan](const gridType& grid, const XY& a, const XY& b) {
+        if (&grid == plan.grid) {
+            notifyWallChanged(plan, a, b);
+        }
+    });
+}
+
+void ip::detach(planner& plan) {
+    if (plan.listenerId != -1) {
+        removeWallListener(plan.listenerId);
+        plan.listenerId = -1;
+    }
+}
+
+// Expand cells until the start location's distance to the goal is known to be correct
+void ip::computeShortestPath(planner& plan) {
+    const int startIdx = cellIndex(*plan.grid, plan.start);
+    while (!plan.open.empty() &&
+           (std::make_pair(std::get<0>(*plan.open.begin()), std::get<1>(*plan.open.begin())) <
+                calculateKey(plan, startIdx) ||
+            plan.rhs[startIdx] != plan.g[startIdx])) {
+        const auto [oldKey1, oldKey2, idx] = *plan.open.begin();
+        const auto newKey = calculateKey(plan, idx);
+        plan.expansions++;
+
+        if (std::make_pair(oldKey1, oldKey2) < newKey) {
+            // The key is out of date, because the start moved since the cell was queued
+            enqueue(plan, idx);
+            continue;
+        }
+
+        const XY cell = cellAt(plan, idx);
+        if (plan.g[idx] > plan.rhs[idx]) {
+            // The cell got closer to the goal. Its neighbors may now get closer through it.
+            plan.g[idx] = plan.rhs[idx];
+            dequeue(plan, idx);
+        } else {
+            // The cell got further from the goal. Re-examine it along with its neighbors.
+            plan.g[idx] = UNREACHABLE;
+            updateVertex(plan, idx);
+        }
+        for (const int direction : DIRECTIONS) {
+            if (isConnected(*plan.grid, cell, direction)) {
+                updateVertex(plan, cellIndex(*plan.grid, neighborOf(cell, direction)));
+            }
+        }
+    }
+}
+
+// Re-examine the cells on either side of a wall which was just opened or closed. Takes effect with the next call to
+// computeShortestPath.
+void ip::notifyWallChanged(planner& plan, const XY& a, const XY& b) {
+    plan.keyModifier += manhattanDistance(plan.lastStart, plan.start);
+    plan.lastStart = plan.start;
+    updateVertex(plan, cellIndex(*plan.grid, a));
+    updateVertex(plan, cellIndex(*plan.grid, b));
+}
+
+// Move the start location, e.g. as the agent following the path takes a step. The search stays valid.
+void ip::moveStart(planner& plan, const XY& newStart) {
+    if (!inBounds(*plan.grid, newStart))
+        throw std::invalid_argument("Start location out of grid bounds");
+    plan.start = newStart;
+}
+
+// Bring the search up to date, then return the shortest path from the start location to the goal. Empty if the goal
+// can't be reached.
+pp::packedPath ip::path(planner& plan) {
+    computeShortestPath(plan);
+
+    if (plan.g[cellIndex(*plan.grid, plan.start)] >= UNREACHABLE) {
+        return pp::packedPath{};
+    }
+    pp::packedPath result = pp::startingAt(plan.start);
+    for (XY current = plan.start; !(current == plan.goal);) {
+        // Step to whichever neighbor is closest to the goal
+        int bestDirection = 0;
+        int bestDistance = UNREACHABLE;
+        for (const int direction : DIRECTIONS) {
+            if (isConnected(*plan.grid, current, direction)) {
+                const int distance = plan.g[cellIndex(*plan.grid, neighborOf(current, direction))];
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    bestDirection = direction;
+                }
+            }
+        }
+        pp::append(result, bestDirection);
+        current = neighborOf(current, bestDirection);
+    }
+    return result;
+}
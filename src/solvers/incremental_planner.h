@@ -0,0 +1,55 @@
+#ifndef INCREMENTAL_PLANNER_H
+#define INCREMENTAL_PLANNER_H
+
+#include <set>
+#include <tuple>
+#include <vector>
+#include "../packed_path.h"
+#include "../utils.h"
+
+using namespace utils;
+
+namespace ip {
+
+// A D* Lite search, kept between calls so that it can be repaired instead of restarted when the maze changes.
+// The search runs backwards, from the goal towards the start, so the start may move (as an agent walks its path)
+// without invalidating anything.
+struct planner {
+    const gridType* grid;
+    int rows;
+    int cols;
+    XY start;
+    XY goal;
+    // The start location when the key modifier was last updated. See moveStart.
+    XY lastStart;
+    // Added to the keys of cells queued after the start moved, so that older keys stay valid lower bounds
+    int keyModifier;
+    // The distance of each cell from the goal, as of its last expansion
+    std::vector<int> g;
+    // The one-step lookahead distance of each cell from the goal, based on its neighbors' g values
+    std::vector<int> rhs;
+    // The cells whose g and rhs values differ, ordered by key. Each entry is (key part 1, key part 2, absolute index).
+    std::set<std::tuple<int, int, int>> open;
+    // The key each cell was queued with, so its entry can be found again. Only meaningful for cells in open.
+    std::vector<std::pair<int, int>> queuedKey;
+    std::vector<bool> queued;
+    // The id of the wall listener registered by attach, or -1
+    int listenerId;
+    // How many cells the search has expanded, in total
+    long long expansions;
+};
+
+// The distance of cells from which the goal can't be reached
+inline constexpr int UNREACHABLE = 1 << 29;
+
+void initialize(planner& plan, const gridType& grid, const XY& startLoc, const XY& goalLoc);
+void attach(planner& plan);
+void detach(planner& plan);
+void computeShortestPath(planner& plan);
+void notifyWallChanged(planner& plan, const XY& a, const XY& b);
+void moveStart(planner& plan, const XY& newStart);
+pp::packedPath path(planner& plan);
+
+}  // namespace ip
+
+#endif /* INCREMENTAL_PLANNER_H */
@@ -0,0 +1,245 @@
+// Contract a maze's corridors into single weighted edges, so that repeated searches on the same maze skip over them.
+// Most cells in a maze made by recursive backtracking have exactly two open sides, and a search which visits cells
+// one by one spends most of its time walking along corridors. Here, each corridor is walked once, while building the
+// graph. Searches then jump from junction to junction, and only the corridors on the final path are walked again,
+// to turn the path of nodes back into a path of cells.
+
+#include "junction_graph.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "../constants.cpp"
+#include "../utils.h"
+
+using namespace constants;
+using namespace utils;
+
+// Where a walk along a corridor ended up
+struct corridorWalk {
+    XY end;
+    int length;
+};
+
+// A node which can be reached from a cell inside a corridor without passing any other node
+struct attachment {
+    int node;
+    int distance;
+    // The direction in which to leave the cell to get to the node
+    int direction;
+};
+
+static int countOpenSides(const gridType& grid, const XY& cell) {
+    int sides = 0;
+    for (const int direction : DIRECTIONS) {
+        sides += isConnected(grid, cell, direction);
+    }
+    return sides;
+}
+
+// Walk along the corridor which leaves the origin in the given direction, until reaching a node, the stop location
+// (if one is given), or the origin again. If stepsWalked isn't null, every step taken is appended to it.
+static corridorWalk walkCorridor(const gridType& grid,
+                                 const std::vector<int>& cellToNode,
+                                 const XY& origin,
+                                 int direction,
+                                 const XY* stopAt,
+                                 pp::packedPath* stepsWalked) {
+    XY current = origin;
+    int length = 0;
+    while (true) {
+        current = neighborOf(current, direction);
+        length++;
+        if (stepsWalked != nullptr) {
+            pp::append(*stepsWalked, direction);
+        }
+        if (cellToNode[cellIndex(grid, current)] != -1 || (stopAt != nullptr && current == *stopAt) ||
+            current == origin) {
+            return corridorWalk{current, length};
+        }
+
+        // Inside a corridor, there's exactly one way to go other than back
+        for (const int next : DIRECTIONS) {
+            if (next != oppositeOf(direction) && isConnected(grid, current, next)) {
+                direction = next;
+                break;
+            }
+        }
+    }
+}
+
+// Build the junction graph of the grid. The graph stays valid for as long as the grid's walls don't change.
+jg::junctionGraph jg::build(const gridType& grid) {
+    junctionGraph graph = {};
+    graph.rows = grid.size();
+    graph.cols = grid.at(0).size();
+    graph.cellToNode.assign(graph.rows * graph.cols, -1);
+
+    for (int y = 0; y < graph.rows; y++) {
+        for (int x = 0; x < graph.cols; x++) {
+            if (countOpenSides(grid, {x, y}) != 2) {
+                graph.cellToNode[y * graph.cols + x] = graph.nodeCells.size();
+                graph.nodeCells.push_back(y * graph.cols + x);
+            }
+        }
+    }
+
+    graph.edgeOffsets.reserve(graph.nodeCells.size() + 1);
+    graph.edgeOffsets.push_back(0);
+    for (const int nodeCell : graph.nodeCells) {
+        const XY origin = {nodeCell % graph.cols, nodeCell / graph.cols};
+        for (const int direction : DIRECTIONS) {
+            if (!isConnected(grid, origin, direction)) {
+                continue;
+            }
+            const auto walk = walkCorridor(grid, graph.cellToNode, origin, direction, nullptr, nullptr);
+            graph.edgeTargets.push_back(graph.cellToNode[cellIndex(grid, walk.end)]);
+            graph.edgeLengths.push_back(walk.length);
+            graph.edgeDirections.push_back(direction);
+        }
+        graph.edgeOffsets.push_back(graph.edgeTargets.size());
+    }
+    return graph;
+}
+
+// Find the shortest path between the start and end locations, searching the junction graph instead of the grid.
+// The grid must be the one the graph was built from.
+jg::queryResult jg::solve(const junctionGraph& graph, const gridType& grid, const XY& startLoc, const XY& endLoc) {
+    if (!inBounds(grid, startLoc))
+        throw std::invalid_argument("Start location out of grid bounds");
+    if (!inBounds(grid, endLoc))
+        throw std::invalid_argument("End location out of grid bounds");
+
+    queryResult result = {};
+    if (startLoc == endLoc) {
+        result.path = pp::startingAt(startLoc);
+        return result;
+    }
+
+    // The start and end locations may lie inside corridors. If so, attach them to the nodes at either end of their
+    // corridor. If the end location is in the same corridor as the start location, it's found on the way.
+    int bestLength = INT_MAX;
+    pp::packedPath directPath = {};
+    std::vector<attachment> startAttachments = {};
+    std::vector<attachment> endAttachments = {};
+
+    const int startNode = graph.cellToNode[cellIndex(grid, startLoc)];
+    if (startNode != -1) {
+        startAttachments.push_back({startNode, 0, 0});
+    } else {
+        for (const int direction : DIRECTIONS) {
+            if (!isConnected(grid, startLoc, direction)) {
+                continue;
+            }
+            pp::packedPath stepsWalked = pp::startingAt(startLoc);
+            const auto walk = walkCorridor(grid, graph.cellToNode, startLoc, direction, &endLoc, &stepsWalked);
+            if (walk.end == endLoc && walk.length < bestLength) {
+                bestLength = walk.length;
+                directPath = stepsWalked;
+            } else if (graph.cellToNode[cellIndex(grid, walk.end)] != -1) {
+                startAttachments.push_back({graph.cellToNode[cellIndex(grid, walk.end)], walk.length, direction});
+            }
+        }
+    }
+
+    const int endNode = graph.cellToNode[cellIndex(grid, endLoc)];
+    if (endNode != -1) {
+        endAttachments.push_back({endNode, 0, 0});
+    } else {
+        for (const int direction : DIRECTIONS) {
+            if (!isConnected(grid, endLoc, direction)) {
+                continue;
+            }
+            const auto walk = walkCorridor(grid, graph.cellToNode, endLoc, direction, nullptr, nullptr);
+            if (graph.cellToNode[cellIndex(grid, walk.end)] != -1) {
+                endAttachments.push_back({graph.cellToNode[cellIndex(grid, walk.end)], walk.length, direction});
+            }
+        }
+    }
+
+    // Dijkstra's algorithm over the nodes, seeded with the start location's attachments
+    const int nodeCount = graph.nodeCells.size();
+    std::vector<int> distance(nodeCount, INT_MAX);
+    std::vector<int> parentEdge(nodeCount, -1);
+    std::vector<int> parentNode(nodeCount, -1);
+    typedef std::pair<int, int> distanceAndNode;
+    std::priority_queue<distanceAndNode, std::vector<distanceAndNode>, std::greater<distanceAndNode>> frontier;
+    for (const auto& seed : startAttachments) {
+        if (seed.distance < distance[seed.node]) {
+            distance[seed.node] = seed.distance;
+            frontier.push({seed.distance, seed.node});
+        }
+    }
+
+    const attachment* bestEnd = nullptr;
+    while (!frontier.empty()) {
+        const auto [nodeDistance, node] = frontier.top();
+        frontier.pop();
+        if (nodeDistance > distance[node]) {
+            // A shorter route to this node was already settled
+            continue;
+        }
+        if (nodeDistance >= bestLength) {
+            break;
+        }
+        result.nodesExpanded++;
+
+        for (const auto& exit : endAttachments) {
+            if (exit.node == node && nodeDistance + exit.distance < bestLength) {
+                bestLength = nodeDistance + exit.distance;
+                bestEnd = &exit;
+            }
+        }
+
+        for (int edge = graph.edgeOffsets[node]; edge < graph.edgeOffsets[node + 1]; edge++) {
+            const int target = graph.edgeTargets[edge];
+            const int targetDistance = nodeDistance + graph.edgeLengths[edge];
+            if (targetDistance < distance[target]) {
+                distance[target] = targetDistance;
+                parentEdge[target] = edge;
+                parentNode[target] = node;
+                frontier.push({targetDistance, target});
+            }
+        }
+    }
+
+    if (bestEnd == nullptr) {
+        // Either the direct path is the shortest, or there is no path at all
+        result.path = directPath;
+        return result;
+    }
+
+    // Expand the path of nodes back into a path of steps, walking each corridor along the way
+    std::vector<int> edgesTaken = {};
+    int firstNode = bestEnd->node;
+    while (parentEdge[firstNode] != -1) {
+        edgesTaken.push_back(parentEdge[firstNode]);
+        firstNode = parentNode[firstNode];
+    }
+    std::reverse(edgesTaken.begin(), edgesTaken.end());
+
+    result.path = pp::startingAt(startLoc);
+    for (const auto& seed : startAttachments) {
+        if (seed.node == firstNode && seed.distance == distance[firstNode]) {
+            if (seed.distance > 0) {
+                walkCorridor(grid, graph.cellToNode, startLoc, seed.direction, nullptr, &result.path);
+            }
+            break;
+        }
+    }
+    for (const int edge : edgesTaken) {
+        const int fromCell = graph.nodeCells[parentNode[graph.edgeTargets[edge]]];
+        const XY from = {fromCell % graph.cols, fromCell / graph.cols};
+        walkCorridor(grid, graph.cellToNode, from, graph.edgeDirections[edge], nullptr, &result.path);
+    }
+    if (bestEnd->distance > 0) {
+        // Walk from the end location to its node, then append that walk in reverse
+        pp::packedPath stepsWalked = pp::startingAt(endLoc);
+        walkCorridor(grid, graph.cellToNode, endLoc, bestEnd->direction, nullptr, &stepsWalked);
+        pp::appendPath(result.path, pp::reversed(stepsWalked));
+    }
+    return result;
+}
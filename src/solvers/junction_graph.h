@@ -0,0 +1,43 @@
+#ifndef JUNCTION_GRAPH_H
+#define JUNCTION_GRAPH_H
+
+#include <vector>
+#include "../packed_path.h"
+#include "../utils.h"
+
+using namespace utils;
+
+namespace jg {
+
+// A maze in which every corridor has been contracted into a single weighted edge.
+// Nodes are the cells which don't have exactly two open sides, i.e. junctions and dead ends. Every other cell lies
+// inside a corridor connecting two nodes. Edges are stored in compressed sparse row form: the edges leaving node n
+// are at positions edgeOffsets[n] up to (but excluding) edgeOffsets[n + 1] of the edge vectors.
+struct junctionGraph {
+    int rows;
+    int cols;
+    // The absolute index of each node's cell
+    std::vector<int> nodeCells;
+    // The node number of each cell, or -1 for cells inside a corridor
+    std::vector<int> cellToNode;
+    std::vector<int> edgeOffsets;
+    std::vector<int> edgeTargets;
+    // The number of steps it takes to walk the edge's corridor
+    std::vector<int> edgeLengths;
+    // The direction in which the edge's corridor leaves its node
+    std::vector<unsigned char> edgeDirections;
+};
+
+struct queryResult {
+    // The path from the start location to the end location. Empty if no path exists.
+    pp::packedPath path;
+    // How many nodes were settled by the search
+    int nodesExpanded;
+};
+
+junctionGraph build(const gridType& grid);
+queryResult solve(const junctionGraph& graph, const gridType& grid, const XY& startLoc, const XY& endLoc);
+
+}  // namespace jg
+
+#endif /* JUNCTION_GRAPH_H */
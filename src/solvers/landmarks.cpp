@@ -0,0 +1,107 @@
+// Precompute the distances from a few landmark cells to every cell, for the ALT (A*, landmarks, triangle inequality)
+// lower bound on the distance between any two cells.
+// Landmarks are chosen by farthest point selection: the first is the cell furthest from the top left corner, and each
+// one after that is the cell furthest from all of the landmarks chosen so far. Landmarks spread out like this sit
+// "behind" most pairs of cells, where the bound is tightest. Each choice depends on the distances from the landmarks
+// before it, so choosing them is sequential, and the distances computed along the way are kept. Given landmarks which
+// were chosen already, e.g. for another maze of the same shape, the distances are computed in parallel instead.
+
+#include "landmarks.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../utils.h"
+#include "distance_field.h"
+
+using namespace utils;
+
+// Choose landmarks by farthest point selection, and compute the distance from each to every cell
+lm::landmarkTable lm::build(const gridType& grid, const int landmarkCount) {
+    if (landmarkCount < 1)
+        throw std::invalid_argument("At least one landmark is required");
+
+    landmarkTable table = {(int)grid.size(), (int)grid.at(0).size(), {}, {}};
+    const int cellCount = table.rows * table.cols;
+    // The distance from each cell to the nearest landmark so far
+    std::vector<std::uint32_t> nearest(cellCount, df::UNREACHABLE);
+    XY next = {0, 0};
+    std::vector<std::uint32_t> fromCorner = df::compute(grid, next).distance;
+    for (int cell = 0; cell < cellCount; cell++) {
+        // Unreachable cells have the largest distance of all, but aren't worth using as landmarks
+        if (fromCorner[cell] != df::UNREACHABLE && fromCorner[cell] > fromCorner[cellIndex(grid, next)]) {
+            next = {cell % table.cols, cell / table.cols};
+        }
+    }
+
+    while ((int)table.landmarks.size() < std::min(landmarkCount, cellCount)) {
+        table.landmarks.push_back(next);
+        table.distance.push_back(std::move(df::compute(grid, next).distance));
+        const auto& latest = table.distance.back();
+        std::uint32_t furthest = 0;
+        for (int cell = 0; cell < cellCount; cell++) {
+            nearest[cell] = std::min(nearest[cell], latest[cell]);
+            if (nearest[cell] != df::UNREACHABLE && nearest[cell] > furthest) {
+                furthest = nearest[cell];
+                next = {cell % table.cols, cell / table.cols};
+            }
+        }
+        if (furthest == 0) {
+            // Every reachable cell is a landmark already
+            break;
+        }
+    }
+    return table;
+}
+
+// Compute the distance from each of the given landmarks to every cell, sharing the landmarks between the given number
+// of threads
+lm::landmarkTable lm::build(const gridType& grid, const std::vector<XY>& landmarks, const int threadCount) {
+    if (threadCount < 1)
+        throw std::invalid_argument("At least one thread is required to build the landmark table");
+    for (const XY& landmark : landmarks) {
+        if (!inBounds(grid, landmark))
+            throw std::invalid_argument("Landmark location out of grid bounds");
+    }
+
+    landmarkTable table = {(int)grid.size(), (int)grid.at(0).size(), landmarks, {}};
+    table.distance.resize(landmarks.size());
+    // Each thread handles every threadCount'th landmark, and only writes to the distances of its own landmarks
+    auto worker = [&](const int threadIdx) {
+        for (std::size_t i = threadIdx; i < landmarks.size(); i += threadCount) {
+            table.distance[i] = std::move(df::compute(grid, landmarks[i]).distance);
+        }
+    };
+    std::vector<std::thread> threads = {};
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return table;
+}
+
+// Return a lower bound on the number of steps between two cells: the largest difference between their distances to
+// any landmark which reaches both
+int lm::lowerBound(const landmarkTable& table, const XY& from, const XY& to) {
+    const int fromIdx = from.y * table.cols + from.x;
+    const int toIdx = to.y * table.cols + to.x;
+    int bound = 0;
+    for (const auto& distance : table.distance) {
+        if (distance[fromIdx] != df::UNREACHABLE && distance[toIdx] != df::UNREACHABLE) {
+            bound = std::max(bound, std::abs((int)distance[fromIdx] - (int)distance[toIdx]));
+        }
+    }
+    return bound;
+}
+
+int lm::landmarkDistance::operator()(const XY& cell, const XY& target) const {
+    const int manhattan = std::abs(target.x - cell.x) + std::abs(target.y - cell.y);
+    if (table == nullptr) {
+        return manhattan;
+    }
+    return std::max(manhattan, lowerBound(*table, cell, target));
+}
@@ -0,0 +1,38 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <cstdint>
+#include <vector>
+#include "../utils.h"
+
+using namespace utils;
+
+namespace lm {
+
+// The distance from each of a few landmark cells to every cell of a maze. By the triangle inequality, the true
+// distance between two cells is at least the difference between their distances to any one landmark, which makes a far
+// tighter lower bound in a maze than the Manhattan distance does.
+struct landmarkTable {
+    int rows;
+    int cols;
+    std::vector<XY> landmarks;
+    // distance[i] holds the number of steps from landmarks[i] to each cell, by absolute index, or df::UNREACHABLE
+    std::vector<std::vector<std::uint32_t>> distance;
+};
+
+// A heuristic for fs::shortestFirstFrontier, which scores cells by the landmark lower bound on their distance to the
+// target, or by their Manhattan distance if that's larger. Without a table, it's just the Manhattan distance. Both
+// bounds are consistent, so A* still finds a shortest path with their maximum.
+struct landmarkDistance {
+    const landmarkTable* table = nullptr;
+
+    int operator()(const XY& cell, const XY& target) const;
+};
+
+landmarkTable build(const gridType& grid, const int landmarkCount);
+landmarkTable build(const gridType& grid, const std::vector<XY>& landmarks, const int threadCount = 1);
+int lowerBound(const landmarkTable& table, const XY& from, const XY& to);
+
+}  // namespace lm
+
+#endif /* LANDMARKS_H */
@@ -0,0 +1,240 @@
+// Find the shortest path between two cells without remembering which cells have been visited, for mazes too large
+// to keep even one bit per cell, e.g. ones streamed from disk or generated on demand. Cells are read through a
+// cellReader, as the wall follower reads them.
+// - IDA* searches depth first, over and over, abandoning any path whose length plus the Manhattan distance left to the
+//   target exceeds a threshold. The threshold starts at the distance from the start to the target, and each pass
+//   raises it to the smallest estimate that went over it. It only holds the path it's currently on, but it expands the
+//   cells near the start again on every pass.
+// - Fringe search makes the same passes, but keeps the cells where the previous pass stopped (its fringe), and
+//   continues from them instead of starting again from the start. It expands far fewer cells, in exchange for holding
+//   the fringe. The path is then recovered by one IDA* pass at the length found.
+// Neither search steps straight back to the cell it just came from. Both can be given a transposition table, with a
+// fixed byte budget, which remembers the fewest steps at which some of the cells were reached, so that a cell reached
+// again by a longer route isn't expanded again. In a perfect maze there is only one route to each cell, so it only
+// helps in mazes with loops.
+
+#include "memory_bounded_solver.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "../constants.cpp"
+#include "../packed_path.h"
+#include "../utils.h"
+#include "heuristics.h"
+
+using namespace constants;
+using namespace utils;
+
+// The cameFrom of the start cell, which wasn't reached from anywhere
+static const std::uint8_t NO_DIRECTION = 4;
+
+// A cell on the depth first search's current path
+struct pathFrame {
+    XY cell;
+    int steps;
+    // The index into DIRECTIONS of the step which reached this cell
+    std::uint8_t cameFrom;
+    // The index into DIRECTIONS of the next neighbor to try
+    std::uint8_t nextDirection;
+};
+
+// A cell on the fringe
+struct fringeNode {
+    XY cell;
+    int steps;
+    std::uint8_t cameFrom;
+};
+
+static int heuristic(const XY& cell, const XY& target) {
+    return fs::manhattanDistance()(cell, target);
+}
+
+static int absoluteIndex(const cellReader& cells, const XY& location) {
+    return location.y * cells.cols + location.x;
+}
+
+// Record that the cell was reached in the given number of steps. Returns false, and records nothing, if the table
+// already holds the cell with no more steps for the same iteration.
+static bool recordReach(mb::transpositionTable& table, const int cell, const int steps, const int iteration) {
+    if (table.entries.empty()) {
+        return true;
+    }
+    auto& entry = table.entries[(std::uint32_t)cell * 2654435761u % table.entries.size()];
+    if (entry.cell == cell && entry.iteration == iteration && entry.steps <= steps) {
+        return false;
+    }
+    entry = {cell, steps, iteration};
+    return true;
+}
+
+// Whether the table holds the cell, for the given iteration, with fewer steps than given
+static bool reachedSooner(const mb::transpositionTable& table, const int cell, const int steps, const int iteration) {
+    if (table.entries.empty()) {
+        return false;
+    }
+    const auto& entry = table.entries[(std::uint32_t)cell * 2654435761u % table.entries.size()];
+    return entry.cell == cell && entry.iteration == iteration && entry.steps < steps;
+}
+
+// Search depth first from the start, abandoning any path whose estimated length exceeds the threshold. On reaching the
+// end, stores the path to it in path and returns -1. Otherwise returns the smallest estimate which exceeded the
+// threshold, or INT_MAX if none did.
+static int depthFirstPass(const cellReader& cells,
+                          const XY& startLoc,
+                          const XY& endLoc,
+                          const int threshold,
+                          mb::transpositionTable& table,
+                          const int iteration,
+                          mb::searchReport& report,
+                          pp::packedPath& path) {
+    int nextThreshold = INT_MAX;
+    std::vector<pathFrame> stack = {{startLoc, 0, NO_DIRECTION, 0}};
+    recordReach(table, absoluteIndex(cells, startLoc), 0, iteration);
+    report.expansions++;
+
+    while (!stack.empty()) {
+        pathFrame& top = stack.back();
+        if (top.nextDirection == 4) {
+            stack.pop_back();
+            continue;
+        }
+        const int code = top.nextDirection++;
+        // Flipping the lowest bit of a direction's index gives the opposite direction
+        if (code == (top.cameFrom ^ 1) || !isConnected(cells, top.cell, DIRECTIONS[code])) {
+            continue;
+        }
+        const XY child = neighborOf(top.cell, DIRECTIONS[code]);
+        const int steps = top.steps + 1;
+        const int estimate = steps + heuristic(child, endLoc);
+        if (estimate > threshold) {
+            nextThreshold = std::min(nextThreshold, estimate);
+            continue;
+        }
+        if (child == endLoc) {
+            path = pp::startingAt(startLoc);
+            for (std::size_t i = 1; i < stack.size(); i++) {
+                pp::append(path, DIRECTIONS[stack[i].cameFrom]);
+            }
+            pp::append(path, DIRECTIONS[code]);
+            return -1;
+        }
+        if (!recordReach(table, absoluteIndex(cells, child), steps, iteration)) {
+            continue;
+        }
+        report.expansions++;
+        stack.push_back({child, steps, (std::uint8_t)code, 0});
+        report.peakNodes = std::max(report.peakNodes, stack.size());
+    }
+    return nextThreshold;
+}
+
+static void checkBounds(const cellReader& cells, const XY& startLoc, const XY& endLoc) {
+    if (startLoc.x < 0 || startLoc.y < 0 || startLoc.x >= cells.cols || startLoc.y >= cells.rows)
+        throw std::invalid_argument("Start location out of grid bounds");
+    if (endLoc.x < 0 || endLoc.y < 0 || endLoc.x >= cells.cols || endLoc.y >= cells.rows)
+        throw std::invalid_argument("End location out of grid bounds");
+}
+
+// Return a table holding as many entries as fit in the given number of bytes
+mb::transpositionTable mb::makeTable(const std::size_t byteBudget) {
+    transpositionTable table = {};
+    table.entries.assign(byteBudget / sizeof(transpositionTable::entry), {-1, 0, 0});
+    return table;
+}
+
+// Find the shortest path from the start to the end location by iterative deepening A*. Uses a transposition table of
+// the given size, if it isn't 0.
+mb::searchReport mb::idaStar(const cellReader& cells,
+                             const XY& startLoc,
+                             const XY& endLoc,
+                             const std::size_t tableBytes) {
+    checkBounds(cells, startLoc, endLoc);
+    searchReport report = {pp::packedPath{}, 0, 0, 1};
+    if (startLoc == endLoc) {
+        report.path = pp::startingAt(startLoc);
+        return report;
+    }
+
+    transpositionTable table = makeTable(tableBytes);
+    // No path which doesn't visit a cell twice is longer than the number of cells
+    const long long longestPath = (long long)cells.rows * cells.cols;
+    for (int threshold = heuristic(startLoc, endLoc); threshold <= longestPath;) {
+        report.iterations++;
+        threshold = depthFirstPass(cells, startLoc, endLoc, threshold, table, report.iterations, report, report.path);
+        if (threshold == -1 || threshold == INT_MAX) {
+            break;
+        }
+    }
+    return report;
+}
+
+// Find the shortest path from the start to the end location by fringe search. Uses a transposition table of the given
+// size, if it isn't 0.
+mb::searchReport mb::fringeSearch(const cellReader& cells,
+                                  const XY& startLoc,
+                                  const XY& endLoc,
+                                  const std::size_t tableBytes) {
+    checkBounds(cells, startLoc, endLoc);
+    searchReport report = {pp::packedPath{}, 0, 0, 1};
+    if (startLoc == endLoc) {
+        report.path = pp::startingAt(startLoc);
+        return report;
+    }
+
+    // The fringe carries over from one pass to the next, so the table's entries do too
+    transpositionTable table = makeTable(tableBytes);
+    const int anyIteration = 0;
+    std::vector<fringeNode> now = {};
+    std::vector<fringeNode> later = {{startLoc, 0, NO_DIRECTION}};
+    recordReach(table, absoluteIndex(cells, startLoc), 0, anyIteration);
+
+    const long long longestPath = (long long)cells.rows * cells.cols;
+    int pathLength = -1;
+    for (int threshold = heuristic(startLoc, endLoc); pathLength == -1 && !later.empty() && threshold <= longestPath;) {
+        report.iterations++;
+        std::swap(now, later);
+        later.clear();
+        int nextThreshold = INT_MAX;
+        while (!now.empty()) {
+            const fringeNode node = now.back();
+            now.pop_back();
+            const int estimate = node.steps + heuristic(node.cell, endLoc);
+            if (estimate > threshold) {
+                nextThreshold = std::min(nextThreshold, estimate);
+                later.push_back(node);
+                continue;
+            }
+            if (node.cell == endLoc) {
+                pathLength = node.steps;
+                break;
+            }
+            // The cell was reached by a shorter route after this node was added
+            if (reachedSooner(table, absoluteIndex(cells, node.cell), node.steps, anyIteration)) {
+                continue;
+            }
+
+            report.expansions++;
+            for (int code = 0; code < 4; code++) {
+                if (code == (node.cameFrom ^ 1) || !isConnected(cells, node.cell, DIRECTIONS[code])) {
+                    continue;
+                }
+                const XY child = neighborOf(node.cell, DIRECTIONS[code]);
+                if (recordReach(table, absoluteIndex(cells, child), node.steps + 1, anyIteration)) {
+                    now.push_back({child, node.steps + 1, (std::uint8_t)code});
+                }
+            }
+            report.peakNodes = std::max(report.peakNodes, now.size() + later.size());
+        }
+        threshold = nextThreshold;
+    }
+
+    if (pathLength != -1) {
+        // The fringe only knows how long the path is. One depth first pass with exactly that threshold finds it again,
+        // without straying further than the fringe did.
+        transpositionTable recoveryTable = makeTable(tableBytes);
+        depthFirstPass(cells, startLoc, endLoc, pathLength, recoveryTable, 1, report, report.path);
+    }
+    return report;
+}
@@ -0,0 +1,46 @@
+#ifndef MEMORY_BOUNDED_SOLVER_H
+#define MEMORY_BOUNDED_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../packed_path.h"
+#include "../utils.h"
+
+using namespace utils;
+
+namespace mb {
+
+// A fixed size cache of the smallest number of steps at which each cell has been reached. Cells are hashed into a
+// direct-mapped array, and a newer entry simply replaces whatever shares its slot, so the table never grows past the
+// byte budget it was given. A table of 0 bytes remembers nothing.
+struct transpositionTable {
+    struct entry {
+        // The absolute index of the cell, or -1 if the slot is empty
+        std::int32_t cell;
+        std::int32_t steps;
+        // Entries only count within the iteration which wrote them
+        std::int32_t iteration;
+    };
+    std::vector<entry> entries;
+};
+
+struct searchReport {
+    // The path from the start location to the end location. Empty if no path was found.
+    pp::packedPath path;
+    // How many cells were expanded, counting a cell again each time it was expanded again
+    long long expansions;
+    // How many times the cost threshold was raised, plus one
+    int iterations;
+    // The largest number of cells held on the search's stack and fringe at any one time
+    std::size_t peakNodes;
+};
+
+transpositionTable makeTable(const std::size_t byteBudget);
+searchReport fringeSearch(const cellReader& cells, const XY& startLoc, const XY& endLoc,
+                          const std::size_t tableBytes = 0);
+searchReport idaStar(const cellReader& cells, const XY& startLoc, const XY& endLoc, const std::size_t tableBytes = 0);
+
+}  // namespace mb
+
+#endif /* MEMORY_BOUNDED_SOLVER_H */
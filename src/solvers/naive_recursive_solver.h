@@ -1,20 +1,22 @@
 #ifndef NAIVE_SOLVER_H
 #define NAIVE_SOLVER_H
 
-#include <deque>
 #include "../../lib/raylib.h"
+#include "../packed_path.h"
+#include "../step_generator.h"
 #include "../utils.h"
+#include "solver_trace.h"
 
 using namespace utils;
 
 namespace ns {
 
-bool nextStep(gridType& grid, XY target, std::deque<XY>& locationsToCheck);
-void animateSolution(gridType& grid);
-void solve(gridType& grid, XY startLoc, XY endLoc);
-
-void _solverDraw(gridType& grid, const int locationIdx);
+void animateSolution(const gridType& grid);
+void reset();
+pp::packedPath solve(const gridType& grid, const XY& startLoc, const XY& endLoc);
+sg::generator<st::stepEvent> steps(const gridType& grid, const XY& startLoc, const XY& endLoc);
+int visitedCount();
 
 }  // namespace ns
 
-#endif /* NAIVE_SOLVER_H */
\ No newline at end of file
+#endif /* NAIVE_SOLVER_H */
@@ -0,0 +1,353 @@
+// Record the order in which a search visits cells, and replay it in a window.
+// Shared by every solver built on the frontier solver template, so that they all draw the same way.
+//
+// Each visit after the first of a chunk starts with a header byte:
+//   bits 0-1: the direction from the reference cell to the visited cell, as an index into DIRECTIONS
+//   bits 2-4: the reference cell. 0 is the previous visit. 1-5 is the visit chunkBack-2 to chunkBack+2 visits ago,
+//             which then becomes the new chunkBack. 6 is the same, with the change to chunkBack in a varint after the
+//             header. 7 means the visited cell isn't next to a recent visit; its offset from the previous visit
+//             follows as two varints, and the direction bits are unused.
+//   bits 5-7: the change in the number of waiting cells since the previous visit, zigzag encoded. 7 means it follows
+//             in a varint instead, after any varints belonging to the reference cell.
+
+#include "solver_trace.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include "../../lib/raylib.h"
+#include "../constants.cpp"
+#include "../render.h"
+#include "../utils.h"
+#include "../viewer.h"
+#include "../wall_layer.h"
+
+using namespace constants;
+
+static const Color SCORE_COLOR = {170, 61, 155, 155};
+
+// How many header codes are used for small changes to chunkBack, and the change the first of them stands for
+static const int NEAR_BACK_CODES = 5;
+static const int NEAR_BACK_MIN = -2;
+static const int FAR_BACK_CODE = 6;
+static const int JUMP_CODE = 7;
+// The largest change in the number of waiting cells which fits in the header, once zigzag encoded
+static const unsigned NEAR_TASK_LIMIT = 7;
+// How far from chunkBack the encoder looks for a neighbor of the visited cell
+static const int BACK_SEARCH_RADIUS = 16;
+
+static unsigned zigzag(const int value) {
+    return ((unsigned)value << 1) ^ (unsigned)(value >> 31);
+}
+
+static int unzigzag(const unsigned value) {
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+static void writeVarint(std::vector<std::uint8_t>& bytes, unsigned value) {
+    while (value >= 0x80) {
+        bytes.push_back((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes.push_back(value);
+}
+
+static unsigned readVarint(const std::vector<std::uint8_t>& bytes, std::size_t& offset) {
+    unsigned value = 0;
+    for (int shift = 0;; shift += 7) {
+        const std::uint8_t byte = bytes[offset++];
+        value |= (unsigned)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+}
+
+static bool isAdjacent(const XY& a, const XY& b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y) == 1;
+}
+
+// The index into DIRECTIONS of the step between two adjacent cells
+static int directionCode(const XY& from, const XY& to) {
+    return std::countr_zero((unsigned)directionTo(from, to));
+}
+
+void st::clear(solveTrace& trace) {
+    trace.bytes.clear();
+    trace.checkpoints.clear();
+    trace.stepCount = 0;
+    trace.chunkCells.clear();
+    trace.chunkBack = 1;
+    trace.lastTaskCount = 0;
+}
+
+void st::recordVisit(solveTrace& trace, const XY& location, const int taskCount) {
+    if (trace.stepCount % TRACE_CHUNK_STEPS == 0) {
+        trace.checkpoints.push_back({trace.bytes.size(), {location, taskCount}});
+        trace.chunkCells.clear();
+        trace.chunkCells.reserve(TRACE_CHUNK_STEPS);
+        trace.chunkCells.push_back(location);
+        trace.chunkBack = 1;
+        trace.lastTaskCount = taskCount;
+        trace.stepCount++;
+        return;
+    }
+
+    const int position = trace.chunkCells.size();
+    const XY& previous = trace.chunkCells.back();
+    int referenceCode = JUMP_CODE;
+    int direction = 0;
+    int newBack = trace.chunkBack;
+    if (isAdjacent(previous, location)) {
+        referenceCode = 0;
+        direction = directionCode(previous, location);
+    } else {
+        // Look outwards from chunkBack for the nearest earlier visit in this chunk which is next to this one
+        for (int distance = 0; distance <= BACK_SEARCH_RADIUS && referenceCode == JUMP_CODE; distance++) {
+            for (const int back : {trace.chunkBack - distance, trace.chunkBack + distance}) {
+                if (back < 2 || back > position || !isAdjacent(trace.chunkCells[position - back], location)) {
+                    continue;
+                }
+                const int change = back - trace.chunkBack;
+                referenceCode = change >= NEAR_BACK_MIN && change < NEAR_BACK_MIN + NEAR_BACK_CODES
+                                    ? 1 + change - NEAR_BACK_MIN
+                                    : FAR_BACK_CODE;
+                direction = directionCode(trace.chunkCells[position - back], location);
+                newBack = back;
+                break;
+            }
+        }
+    }
+
+    const unsigned taskChange = zigzag(taskCount - trace.lastTaskCount);
+    const unsigned taskCode = taskChange < NEAR_TASK_LIMIT ? taskChange : NEAR_TASK_LIMIT;
+    trace.bytes.push_back(direction | referenceCode << 2 | taskCode << 5);
+    if (referenceCode == FAR_BACK_CODE) {
+        writeVarint(trace.bytes, zigzag(newBack - trace.chunkBack));
+    } else if (referenceCode == JUMP_CODE) {
+        writeVarint(trace.bytes, zigzag(location.x - previous.x));
+        writeVarint(trace.bytes, zigzag(location.y - previous.y));
+    }
+    if (taskCode == NEAR_TASK_LIMIT) {
+        writeVarint(trace.bytes, taskChange);
+    }
+
+    trace.chunkCells.push_back(location);
+    trace.chunkBack = newBack;
+    trace.lastTaskCount = taskCount;
+    trace.stepCount++;
+}
+
+// Decode the first count visits of the given chunk into visits, replacing its contents. Visits only refer back to
+// earlier ones in the same chunk, so decoding can stop at any of them.
+static void decodeVisits(const st::solveTrace& trace,
+                         const std::size_t chunkIdx,
+                         const std::size_t count,
+                         std::vector<st::stepEvent>& visits) {
+    const st::traceCheckpoint& checkpoint = trace.checkpoints[chunkIdx];
+    visits.clear();
+    visits.reserve(count);
+    visits.push_back(checkpoint.first);
+
+    std::size_t offset = checkpoint.byteOffset;
+    int chunkBack = 1;
+    while (visits.size() < count) {
+        const std::uint8_t header = trace.bytes[offset++];
+        const int direction = DIRECTIONS[header & 3];
+        const int referenceCode = (header >> 2) & 7;
+        const unsigned taskCode = header >> 5;
+        const st::stepEvent previous = visits.back();
+
+        XY location;
+        if (referenceCode == 0) {
+            location = neighborOf(previous.cell, direction);
+        } else if (referenceCode == JUMP_CODE) {
+            const int dx = unzigzag(readVarint(trace.bytes, offset));
+            const int dy = unzigzag(readVarint(trace.bytes, offset));
+            location = {previous.cell.x + dx, previous.cell.y + dy};
+        } else {
+            chunkBack += referenceCode == FAR_BACK_CODE ? unzigzag(readVarint(trace.bytes, offset))
+                                                        : referenceCode - 1 + NEAR_BACK_MIN;
+            location = neighborOf(visits[visits.size() - chunkBack].cell, direction);
+        }
+        const unsigned taskChange = taskCode == NEAR_TASK_LIMIT ? readVarint(trace.bytes, offset) : taskCode;
+        visits.push_back({location, previous.taskCount + unzigzag(taskChange)});
+    }
+}
+
+// Decode every visit in the given chunk into visits, replacing its contents
+void st::decodeChunk(const solveTrace& trace, const std::size_t chunkIdx, std::vector<stepEvent>& visits) {
+    if (chunkIdx >= trace.checkpoints.size())
+        throw std::out_of_range("The trace has no chunk " + std::to_string(chunkIdx));
+    decodeVisits(trace, chunkIdx, std::min(TRACE_CHUNK_STEPS, trace.stepCount - chunkIdx * TRACE_CHUNK_STEPS), visits);
+}
+
+// Return the number of bytes of memory the trace holds, including spare capacity
+std::size_t st::memoryBytes(const solveTrace& trace) {
+    return sizeof(trace) + trace.bytes.capacity() + trace.checkpoints.capacity() * sizeof(traceCheckpoint) +
+           trace.chunkCells.capacity() * sizeof(XY);
+}
+
+// Return the number of visits in the trace
+std::size_t st::size(const solveTrace& trace) {
+    return trace.stepCount;
+}
+
+// Return the visit at the given index. This decodes the chunk holding it, up to that visit.
+st::stepEvent st::stepAt(const solveTrace& trace, const std::size_t stepIdx) {
+    if (stepIdx >= trace.stepCount)
+        throw std::out_of_range("The trace has no step " + std::to_string(stepIdx));
+    std::vector<stepEvent> visits = {};
+    decodeVisits(trace, stepIdx / TRACE_CHUNK_STEPS, stepIdx % TRACE_CHUNK_STEPS + 1, visits);
+    return visits.back();
+}
+
+// Prepare to animate a search of the given grid. Expects an open window or canvas.
+st::traceView st::_openTraceView(const gridType& grid) {
+    const int rows = grid.size();
+    const int cols = grid.at(0).size();
+    return {wl::load(grid, wallColor),
+            rd::loadLayer(rd::frameWidth(), rd::frameHeight()),
+            std::vector<Color>((std::size_t)rows * cols, BLANK),
+            rows,
+            cols,
+            rd::currentCamera(),
+            {},
+            0};
+}
+
+void st::_closeTraceView(traceView& view) {
+    wl::unload(view.walls);
+    rd::unloadLayer(view.settled);
+    view.settledColors = {};
+    view.recent.clear();
+    view.visitCount = 0;
+    view.changed = {0, 0, 0, 0};
+}
+
+// Widen the range of cells to hold the given cell
+static void include(vw::cellRange& range, const XY& cell) {
+    if (range.maxX <= range.minX) {
+        range = {cell.x, cell.y, cell.x + 1, cell.y + 1};
+        return;
+    }
+    range = {std::min(range.minX, cell.x), std::min(range.minY, cell.y), std::max(range.maxX, cell.x + 1),
+             std::max(range.maxY, cell.y + 1)};
+}
+
+// Draw every settled visit the camera shows into the settled layer, replacing what was there
+static void redrawSettled(st::traceView& view) {
+    const vw::cellRange visible = vw::visibleCells(view.rows, view.cols);
+    rd::beginLayer(view.settled);
+    rd::clear(BLANK);
+    for (int y = visible.minY; y < visible.maxY; y++) {
+        for (int x = visible.minX; x < visible.maxX; x++) {
+            const Color clr = view.settledColors[(std::size_t)y * view.cols + x];
+            if (clr.a != 0) {
+                rd::rectangle(x * CELLWIDTH, y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1, clr);
+            }
+        }
+    }
+    rd::endLayer();
+    view.drawnThrough = rd::currentCamera();
+}
+
+// Add the given visit to the view, which must follow the last visit added to it, without drawing a frame. Several
+// visits can be added between frames; each is drawn as if a frame had been drawn for it. It expects an open window or
+// canvas.
+void st::_traceVisit(traceView& view, const stepEvent& checkedVisit) {
+    // The number of visits before this one, which is also this visit's index
+    const std::size_t locationIdx = view.visitCount;
+
+    // Settle the oldest visit in the tail, in the color it would have been drawn in this visit's frame
+    if (view.recent.size() >= VISIT_TAIL_LENGTH) {
+        const XY settling = view.recent.front();
+        const Color clr = utils::gradateColor(cellFocusColor, RAYWHITE, locationIdx - view.recent.size(), locationIdx);
+        view.settledColors[(std::size_t)settling.y * view.cols + settling.x] = clr;
+        // Zoomed out, the settled layer isn't drawn, and is drawn again from settledColors once zoomed back in
+        if (vw::detailLevel() == 0) {
+            rd::beginLayer(view.settled);
+            rd::rectangle(settling.x * CELLWIDTH, settling.y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1, clr);
+            rd::endLayer();
+        }
+        view.recent.pop_front();
+    }
+    ov::markVisited(view.walls.overview, checkedVisit.cell);
+    include(view.changed, checkedVisit.cell);
+    view.recent.push_back(checkedVisit.cell);
+    view.latest = checkedVisit;
+    view.visitCount++;
+}
+
+// This helper function draws the state of the search as of the last visit added to the view. It expects an open window
+// or canvas, and at least one visit. If drawScores is set, every cell is labelled with its Manhattan distance to the
+// end point.
+void st::_traceFrame(traceView& view, const XY& mazeEndpoint, const bool drawScores) {
+    // The index of the last visit, which is the newest in the tail, and is drawn as the current cell instead
+    const std::size_t locationIdx = view.visitCount - 1;
+    const stepEvent& checkedVisit = view.latest;
+    const auto checkedLocation = checkedVisit.cell;
+    // Zoomed out until cells are smaller than a pixel, the wall layer draws the overview over the cells instead
+    const bool zoomedOut = vw::detailLevel() > 0;
+
+    if (zoomedOut) {
+        // The settled layer misses whatever settles while zoomed out, so draw it again once zoomed back in
+        view.drawnThrough.zoom = 0;
+    } else if (!vw::sameView(view.drawnThrough, rd::currentCamera())) {
+        redrawSettled(view);
+    }
+
+    // Only the tail has moved since the last frame, so only its cells, with their walls, are drawn again. Zoomed out,
+    // the overview draws several cells to a pixel, so the frame is drawn whole.
+    if (!zoomedOut && view.changed.maxX > view.changed.minX) {
+        rd::markDirty(view.changed.minX * CELLWIDTH, view.changed.minY * CELLHEIGHT,
+                      (view.changed.maxX - view.changed.minX) * CELLWIDTH + 1,
+                      (view.changed.maxY - view.changed.minY) * CELLHEIGHT + 1);
+    }
+    view.changed = {0, 0, 0, 0};
+    for (const XY& cell : view.recent) {
+        include(view.changed, cell);
+    }
+
+    rd::clear(RAYWHITE);
+
+    // The offsets are intended to stop these shapes from being drawn over the walls of the maze
+    rd::rectangle(mazeEndpoint.x * CELLWIDTH, mazeEndpoint.y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1,
+                  mazeEndpointColor);
+    rd::rectangle(checkedLocation.x * CELLWIDTH, checkedLocation.y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1,
+                  cellFocusColor);
+
+    // Add indication of previously visited cells
+    if (!zoomedOut) {
+        rd::drawLayer(view.settled, 0, 0);
+    }
+    std::size_t i = view.visitCount - view.recent.size();
+    for (auto visited = view.recent.begin(); visited + 1 < view.recent.end(); visited++) {
+        Color clr = utils::gradateColor(cellFocusColor, RAYWHITE, i++, locationIdx);
+        rd::rectangle(visited->x * CELLWIDTH, visited->y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1, clr);
+    }
+
+    wl::draw(view.walls);
+    // The overview covers the cells, so mark the end point and the current cell again over it
+    if (zoomedOut) {
+        rd::rectangle(mazeEndpoint.x * CELLWIDTH, mazeEndpoint.y * CELLHEIGHT, CELLWIDTH, CELLHEIGHT,
+                      mazeEndpointColor);
+        rd::rectangle(checkedLocation.x * CELLWIDTH, checkedLocation.y * CELLHEIGHT, CELLWIDTH, CELLHEIGHT,
+                      cellFocusColor);
+    }
+    const vw::cellRange visible = vw::visibleCells(view.rows, view.cols);
+    for (int y = visible.minY; y < visible.maxY && drawScores && rd::textShown(); y++) {
+        for (int x = visible.minX; x < visible.maxX; x++) {
+            const int score = std::abs(mazeEndpoint.x - x) + std::abs(mazeEndpoint.y - y);
+            rd::text(TextFormat("%01i", score), x * CELLWIDTH + 5, y * CELLHEIGHT + 5, 6, SCORE_COLOR);
+        }
+    }
+    rd::screenText(TextFormat("Queue len: %01i", checkedVisit.taskCount), 5, 5, 0, MAROON);
+}
+
+// Add the given visit to the view, and draw the state of the search as of that visit. See _traceVisit and _traceFrame.
+void st::_traceDraw(traceView& view, const stepEvent& checkedVisit, const XY& mazeEndpoint, const bool drawScores) {
+    _traceVisit(view, checkedVisit);
+    _traceFrame(view, mazeEndpoint, drawScores);
+}
@@ -0,0 +1,106 @@
+#ifndef SOLVER_TRACE_H
+#define SOLVER_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "../../lib/raylib.h"
+#include "../render.h"
+#include "../utils.h"
+#include "../viewer.h"
+#include "../wall_layer.h"
+
+using namespace utils;
+
+namespace st {
+
+// One visit made by a search
+struct stepEvent {
+    XY cell;
+    // The number of cells waiting to be visited when this one was, including this one. 0 for the target.
+    int taskCount;
+};
+
+// The number of visits encoded in each chunk of a trace
+inline constexpr std::size_t TRACE_CHUNK_STEPS = 4096;
+
+// Where a chunk of a trace starts. Each chunk can be decoded on its own, starting from its checkpoint.
+struct traceCheckpoint {
+    std::size_t byteOffset;
+    stepEvent first;
+};
+
+// A record of a search, in enough detail to replay it, in roughly one byte per visit.
+// Each visit after the first of its chunk is encoded relative to a visit shortly before it in the same chunk: usually
+// the previous one, which a depth or best first search has almost always just stepped away from. A breadth first
+// search instead steps away from the cell it visited one wavefront ago, so the distance back to that visit is tracked
+// too. Cells which aren't next to any recent visit, and large changes in the number of waiting cells, are written out
+// as varints. Use recordVisit to add to it, and stepAt or forEachVisit to read it.
+struct solveTrace {
+    std::vector<std::uint8_t> bytes;
+    std::vector<traceCheckpoint> checkpoints;
+    std::size_t stepCount = 0;
+
+    // The encoder's state: the visits so far in the last chunk, and how far back the last visit found its neighbor
+    std::vector<XY> chunkCells;
+    int chunkBack = 1;
+    int lastTaskCount = 0;
+};
+
+// How many of a search's most recent visits are redrawn each frame, fading as the search moves on
+inline constexpr std::size_t VISIT_TAIL_LENGTH = 64;
+
+// What has been drawn of an animated search so far, so that each frame only draws what has changed since the last.
+// Visits which have left the tail are drawn once, into a layer, in the color they had when they left it. The layer
+// only holds what the camera shows, so their colors are kept by cell, to draw the layer again when it moves.
+struct traceView {
+    wl::wallLayer walls;
+    rd::layer settled;
+    // The color each cell was settled in, row by row, or blank if it hasn't been
+    std::vector<Color> settledColors;
+    int rows;
+    int cols;
+    // The camera the settled layer was last drawn through
+    Camera2D drawnThrough;
+    // The visits in the tail, oldest first
+    std::deque<XY> recent;
+    // How many visits have been added, and the last of them
+    std::size_t visitCount = 0;
+    stepEvent latest = {};
+    // The cells which may look different from the last frame drawn: the tail as of that frame, and every visit since
+    vw::cellRange changed = {0, 0, 0, 0};
+};
+
+void clear(solveTrace& trace);
+void decodeChunk(const solveTrace& trace, const std::size_t chunkIdx, std::vector<stepEvent>& visits);
+std::size_t memoryBytes(const solveTrace& trace);
+void recordVisit(solveTrace& trace, const XY& location, const int taskCount);
+std::size_t size(const solveTrace& trace);
+stepEvent stepAt(const solveTrace& trace, const std::size_t stepIdx);
+traceView _openTraceView(const gridType& grid);
+void _closeTraceView(traceView& view);
+void _traceVisit(traceView& view, const stepEvent& visit);
+void _traceFrame(traceView& view, const XY& mazeEndpoint, const bool drawScores);
+void _traceDraw(traceView& view, const stepEvent& visit, const XY& mazeEndpoint, const bool drawScores);
+
+// Call visit(stepIdx, event) for each of the first count visits in the trace, in order. Only one chunk is decoded at
+// a time.
+template <typename Visitor>
+void forEachVisit(const solveTrace& trace, std::size_t count, Visitor&& visit) {
+    if (count > trace.stepCount) {
+        count = trace.stepCount;
+    }
+    std::vector<stepEvent> visits = {};
+    for (std::size_t chunk = 0; chunk * TRACE_CHUNK_STEPS < count; chunk++) {
+        decodeChunk(trace, chunk, visits);
+        const std::size_t chunkStart = chunk * TRACE_CHUNK_STEPS;
+        for (std::size_t i = 0; i < visits.size() && chunkStart + i < count; i++) {
+            visit(chunkStart + i, visits[i]);
+        }
+    }
+}
+
+}  // namespace st
+
+#endif /* SOLVER_TRACE_H */
@@ -0,0 +1,165 @@
+// Answer point-to-point queries on a perfect maze without searching.
+// Every maze the generators produce is perfect: there is exactly one path between any two cells, so the maze is a
+// tree. Root it anywhere, and the path between two cells runs up from the first to their lowest common ancestor, then
+// down to the second. Binary lifting finds that ancestor in O(log n) steps, which makes distance queries O(log n),
+// and path queries O(path length).
+
+#include "tree_path_index.h"
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+#include "../constants.cpp"
+#include "../utils.h"
+
+using namespace constants;
+using namespace utils;
+
+// Build the index. Throws if the maze isn't perfect, i.e. if some cells are unreachable or the maze contains loops.
+tp::pathIndex tp::build(const gridType& grid) {
+    pathIndex index = {};
+    index.rows = grid.size();
+    index.cols = grid.at(0).size();
+    const int cellCount = index.rows * index.cols;
+
+    // A connected graph with one edge fewer than it has nodes is a tree
+    int edgeCount = 0;
+    for (int y = 0; y < index.rows; y++) {
+        for (int x = 0; x < index.cols; x++) {
+            edgeCount += isConnected(grid, {x, y}, EAST) + isConnected(grid, {x, y}, SOUTH);
+        }
+    }
+
+    // Breadth first search from the root, noting each cell's parent and depth
+    std::vector<int>& parent = index.parent;
+    parent.assign(cellCount, -1);
+    index.depth.assign(cellCount, 0);
+    parent[0] = 0;
+    int cellsReached = 1;
+    int maxDepth = 0;
+    std::deque<XY> locationsToCheck = {{0, 0}};
+    while (!locationsToCheck.empty()) {
+        const XY origin = locationsToCheck.front();
+        locationsToCheck.pop_front();
+        const int originIdx = cellIndex(grid, origin);
+        for (const int direction : DIRECTIONS) {
+            if (!isConnected(grid, origin, direction)) {
+                continue;
+            }
+            const XY neighbor = neighborOf(origin, direction);
+            const int neighborIdx = cellIndex(grid, neighbor);
+            if (parent[neighborIdx] == -1) {
+                parent[neighborIdx] = originIdx;
+                index.depth[neighborIdx] = index.depth[originIdx] + 1;
+                maxDepth = std::max(maxDepth, index.depth[neighborIdx]);
+                cellsReached++;
+                locationsToCheck.push_back(neighbor);
+            }
+        }
+    }
+
+    if (cellsReached != cellCount || edgeCount != cellCount - 1) {
+        throw std::invalid_argument("The maze must be perfect: every cell reachable, and no loops");
+    }
+
+    // Enough levels to jump the full depth of the tree
+    index.levels = std::max(1, (int)std::bit_width((unsigned)maxDepth));
+    index.ancestors.resize((std::size_t)cellCount * index.levels);
+    for (int cell = 0; cell < cellCount; cell++) {
+        index.ancestors[(std::size_t)cell * index.levels] = parent[cell];
+    }
+    for (int level = 1; level < index.levels; level++) {
+        for (std::size_t cell = 0; cell < (std::size_t)cellCount; cell++) {
+            const int halfway = index.ancestors[cell * index.levels + level - 1];
+            index.ancestors[cell * index.levels + level] =
+                index.ancestors[(std::size_t)halfway * index.levels + level - 1];
+        }
+    }
+    return index;
+}
+
+// Return the absolute index of the deepest cell that's an ancestor of both cells
+int tp::lowestCommonAncestor(const pathIndex& index, int cellA, int cellB) {
+    const std::size_t levels = index.levels;
+    if (index.depth[cellA] < index.depth[cellB]) {
+        std::swap(cellA, cellB);
+    }
+
+    // Lift the deeper cell up to the same depth as the other
+    const int difference = index.depth[cellA] - index.depth[cellB];
+    for (int level = 0; level < index.levels; level++) {
+        if ((difference >> level) & 1) {
+            cellA = index.ancestors[cellA * levels + level];
+        }
+    }
+    if (cellA == cellB) {
+        return cellA;
+    }
+
+    // Lift both as far as possible while they stay apart. They then sit just below their common ancestor.
+    for (int level = index.levels - 1; level >= 0; level--) {
+        const int ancestorA = index.ancestors[cellA * levels + level];
+        const int ancestorB = index.ancestors[cellB * levels + level];
+        if (ancestorA != ancestorB) {
+            cellA = ancestorA;
+            cellB = ancestorB;
+        }
+    }
+    return index.parent[cellA];
+}
+
+static void checkInIndex(const tp::pathIndex& index, const XY& location) {
+    if (location.x < 0 || location.y < 0 || location.x >= index.cols || location.y >= index.rows)
+        throw std::invalid_argument("Location out of grid bounds");
+}
+
+// Return the number of steps on the path between the two locations
+int tp::distance(const pathIndex& index, const XY& a, const XY& b) {
+    checkInIndex(index, a);
+    checkInIndex(index, b);
+    const int cellA = a.y * index.cols + a.x;
+    const int cellB = b.y * index.cols + b.x;
+    const int ancestor = lowestCommonAncestor(index, cellA, cellB);
+    return index.depth[cellA] + index.depth[cellB] - 2 * index.depth[ancestor];
+}
+
+// Return the path from a to b
+pp::packedPath tp::path(const pathIndex& index, const XY& a, const XY& b) {
+    checkInIndex(index, a);
+    checkInIndex(index, b);
+    int cellA = a.y * index.cols + a.x;
+    int cellB = b.y * index.cols + b.x;
+    const int ancestor = lowestCommonAncestor(index, cellA, cellB);
+    // Parents are always next to their children, so the step to a cell's parent follows from the difference of their
+    // indices. Returns the step's index into DIRECTIONS. Vertical steps are checked first: in a maze one cell wide,
+    // they differ by one too.
+    auto stepToParent = [&index](const int cell) {
+        const int offset = index.parent[cell] - cell;
+        if (offset == -index.cols) {
+            return 0;
+        }
+        if (offset == index.cols) {
+            return 1;
+        }
+        return offset > 0 ? 2 : 3;
+    };
+
+    pp::packedPath result = pp::startingAt(a);
+    result.steps.reserve((index.depth[cellA] + index.depth[cellB] - 2 * index.depth[ancestor]) / 4 + 1);
+    for (; cellA != ancestor; cellA = index.parent[cellA]) {
+        pp::append(result, DIRECTIONS[stepToParent(cellA)]);
+    }
+
+    // The second half is walked from b upwards, so append it in reverse, with every step turned around. Flipping the
+    // lowest bit of an index into DIRECTIONS gives the opposite direction.
+    std::vector<unsigned char> stepsFromB = {};
+    stepsFromB.reserve(index.depth[cellB] - index.depth[ancestor]);
+    for (; cellB != ancestor; cellB = index.parent[cellB]) {
+        stepsFromB.push_back(stepToParent(cellB));
+    }
+    for (auto step = stepsFromB.rbegin(); step != stepsFromB.rend(); step++) {
+        pp::append(result, DIRECTIONS[*step ^ 1]);
+    }
+    return result;
+}
@@ -0,0 +1,37 @@
+#ifndef TREE_PATH_INDEX_H
+#define TREE_PATH_INDEX_H
+
+#include <vector>
+#include "../packed_path.h"
+#include "../utils.h"
+
+using namespace utils;
+
+namespace tp {
+
+// An index over a perfect maze, which is a tree rooted at cell (0,0). Every cell knows its depth in the tree, and
+// its ancestors at power-of-two distances above it. That's enough to find the lowest common ancestor of any two
+// cells, and with it the unique path between them, without any searching.
+struct pathIndex {
+    int rows;
+    int cols;
+    // The number of ancestor levels stored per cell
+    int levels;
+    // The distance of each cell from the root
+    std::vector<int> depth;
+    // The absolute index of each cell's parent, for walking paths one step at a time. The root is its own parent.
+    std::vector<int> parent;
+    // The absolute index of the ancestor 2^k steps above cell c is at ancestors[c * levels + k]. Keeping each cell's
+    // ancestors next to each other means a query touches one cache line per cell it jumps to. The root is its own
+    // ancestor.
+    std::vector<int> ancestors;
+};
+
+pathIndex build(const gridType& grid);
+int lowestCommonAncestor(const pathIndex& index, int cellA, int cellB);
+int distance(const pathIndex& index, const XY& a, const XY& b);
+pp::packedPath path(const pathIndex& index, const XY& a, const XY& b);
+
+}  // namespace tp
+
+#endif /* TREE_PATH_INDEX_H */
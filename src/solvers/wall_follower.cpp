@@ -0,0 +1,181 @@
+// Given a grid, find a contiguous line between the defined start point and end point by following a wall.
+// The follower keeps one hand on a wall and walks until it reaches the target. It remembers nothing but its position
+// and heading, and reads each cell as it gets there, so it needs the same tiny amount of memory for any size of maze.
+// - LEFT_HAND and RIGHT_HAND always reach the target in a perfect maze, since every wall there is connected to the
+//   outer wall.
+// - PLEDGE walks straight towards the target whenever it can, and only follows a wall (with its left hand) until the
+//   turns it made along the wall cancel out. It can take shortcuts, but it isn't guaranteed to reach a target which
+//   lies inside the maze.
+
+#include "wall_follower.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include "../../lib/raylib.h"
+#include "../constants.cpp"
+#include "../hud.h"
+#include "../log.h"
+#include "../pacing.h"
+#include "../render.h"
+#include "../utils.h"
+#include "../viewer.h"
+#include "../wall_layer.h"
+
+using namespace constants;
+using namespace utils;
+
+// The headings, in clockwise order. Turning right adds 1 to an index into this array, turning left subtracts 1.
+static const int HEADINGS[4] = {NORTH, EAST, SOUTH, WEST};
+
+// Return the state of a follower standing at the start location, which hasn't taken any steps yet
+wf::followerState wf::startAt(const XY& startLoc, const XY& endLoc) {
+    // Prefer whichever heading closes the larger of the two distances to the target
+    const int dx = endLoc.x - startLoc.x;
+    const int dy = endLoc.y - startLoc.y;
+    const int preferred = std::abs(dx) >= std::abs(dy) ? (dx >= 0 ? 1 : 3) : (dy >= 0 ? 2 : 0);
+    return followerState{startLoc, preferred, preferred, 0, 0};
+}
+
+// Move the follower by one cell, according to the rule. Does nothing once the target is reached.
+void wf::nextStep(const cellReader& cells, const XY& target, const wallFollowerRule rule, followerState& state) {
+    if (state.position == target) {
+        return;
+    }
+
+    if (rule == PLEDGE && state.turnSum == 0 && isConnected(cells, state.position, HEADINGS[state.preferredHeading])) {
+        state.heading = state.preferredHeading;
+        state.position = neighborOf(state.position, HEADINGS[state.heading]);
+        state.steps++;
+        return;
+    }
+
+    // Turn towards the hand on the wall if possible, else go straight on, else turn away from the wall, else go back
+    const int handSide = rule == RIGHT_HAND ? 1 : -1;
+    const int turns[4] = {handSide, 0, -handSide, 2};
+    for (const int turn : turns) {
+        const int heading = (state.heading + turn + 4) % 4;
+        if (isConnected(cells, state.position, HEADINGS[heading])) {
+            state.heading = heading;
+            state.turnSum += turn;
+            state.position = neighborOf(state.position, HEADINGS[heading]);
+            break;
+        }
+    }
+    // A cell without any open sides still counts as a step, so that step limits end the walk
+    state.steps++;
+}
+
+// Walk from the start location until the target is found, or the follower is evidently going in circles.
+// Returns statistics about the walk. If route isn't null, the walk is recorded in it, minus any dead ends the follower
+// walked into and back out of. Recording takes two bits per step, so the memory used no longer stays constant.
+wf::followerReport wf::solve(const cellReader& cells,
+                             const XY& startLoc,
+                             const XY& endLoc,
+                             const wallFollowerRule rule,
+                             pp::packedPath* route) {
+    auto inReaderBounds = [&cells](const XY& loc) {
+        return loc.x >= 0 && loc.y >= 0 && loc.x < cells.cols && loc.y < cells.rows;
+    };
+    if (!inReaderBounds(startLoc))
+        throw std::invalid_argument("Start location out of grid bounds");
+    if (!inReaderBounds(endLoc))
+        throw std::invalid_argument("End location out of grid bounds");
+
+    // In a perfect maze, a wall follower walks along each passage at most twice
+    const long long stepLimit = 4LL * cells.rows * cells.cols;
+
+    auto state = startAt(startLoc, endLoc);
+    if (route != nullptr) {
+        *route = pp::startingAt(startLoc);
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    while (!(state.position == endLoc) && state.steps < stepLimit) {
+        const XY previous = state.position;
+        nextStep(cells, endLoc, rule, state);
+        if (route != nullptr && !(state.position == previous)) {
+            pp::appendRetracing(*route, HEADINGS[state.heading]);
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    followerReport report = {state.position == endLoc, state.steps, 0, peakResidentMemoryKb()};
+    if (elapsed.count() > 0) {
+        report.cellsPerSecond = state.steps / elapsed.count();
+    }
+
+    if (report.found) {
+        MAZE_LOG(LEVEL_INFO, LOG_SOLVER,
+                 "FOUND target at " << endLoc.x << ',' << endLoc.y << " after " << report.steps << " steps ("
+                                    << (long long)report.cellsPerSecond << " cells/s, peak memory "
+                                    << report.peakMemoryKb << " KB)");
+        lg::flush();
+    } else {
+        lg::flush();
+        std::cerr << "Failed to find solution connecting points (" << startLoc.x << "," << startLoc.y << ") and ("
+                  << endLoc.x << "," << endLoc.y << ") within " << stepLimit << " steps" << std::endl;
+    }
+    return report;
+}
+
+// Animate the follower's walk, taking as many steps per frame as pacing asks for. Steps are taken as they're drawn, so
+// nothing is stored.
+void wf::animateSolution(const gridType& grid, const wallFollowerRule rule) {
+    const cellReader cells = readerFor(grid);
+    const long long stepLimit = 4LL * cells.rows * cells.cols;
+    auto state = startAt(solverStart, solverEnd);
+    auto walls = wl::load(grid, wallColor);
+    // In a perfect maze, the follower walks along each passage at most twice
+    pc::begin(2LL * cells.rows * cells.cols, FPS_SOLVING);
+    rd::setTargetFPS(FPS_SOLVING);
+    bool done = false;
+    // Whether the outcome of the walk has been logged, which happens once, on the frame it ends
+    bool reported = false;
+    while (!rd::shouldClose(done)) {
+        vw::update();
+        pc::update();
+        hd::update();
+        rd::beginFrame();
+        // The overview, drawn in place of the cells when zoomed out, shows where the follower has been
+        ov::markVisited(walls.overview, state.position);
+        wf::_solverDraw(walls, state);
+        done = state.position == solverEnd || state.steps >= stepLimit;
+        if (done && !reported) {
+            if (state.position == solverEnd) {
+                MAZE_LOG(LEVEL_INFO, LOG_SOLVER,
+                         "FOUND target at " << solverEnd.x << ',' << solverEnd.y << " after " << state.steps
+                                            << " steps");
+            } else {
+                std::cerr << "Failed to find solution connecting points (" << solverStart.x << "," << solverStart.y
+                          << ") and (" << solverEnd.x << "," << solverEnd.y << ") within " << stepLimit << " steps"
+                          << std::endl;
+            }
+            reported = true;
+        }
+        if (!done) {
+            pc::advance([&]() {
+                wf::nextStep(cells, solverEnd, rule, state);
+                ov::markVisited(walls.overview, state.position);
+                return !(state.position == solverEnd) && state.steps < stepLimit;
+            });
+        }
+        hd::draw(ov::visitedCount(walls.overview), (long long)cells.rows * cells.cols);
+        rd::endFrame();
+    }
+    wl::unload(walls);
+    rd::close();
+}
+
+// This helper function draws the follower's position in the grid. It expects an open window or canvas.
+void wf::_solverDraw(wl::wallLayer& walls, const followerState& state) {
+    rd::clear(RAYWHITE);
+
+    // The offsets are intended to stop these shapes from being drawn over the walls of the maze
+    rd::rectangle(solverEnd.x * CELLWIDTH, solverEnd.y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1,
+                  mazeEndpointColor);
+    rd::rectangle(state.position.x * CELLWIDTH, state.position.y * CELLHEIGHT + 1, CELLWIDTH - 1, CELLHEIGHT - 1,
+                  cellFocusColor);
+
+    wl::draw(walls);
+    rd::screenText(TextFormat("Steps: %01i", (int)state.steps), 5, 5, 0, MAROON);
+}
@@ -0,0 +1,46 @@
+#ifndef WALL_FOLLOWER_H
+#define WALL_FOLLOWER_H
+
+#include "../../lib/raylib.h"
+#include "../constants.cpp"
+#include "../packed_path.h"
+#include "../utils.h"
+#include "../wall_layer.h"
+
+using namespace utils;
+
+namespace wf {
+
+// Everything the wall follower knows. Its size doesn't depend on the size of the maze.
+struct followerState {
+    XY position;
+    // An index into the clockwise list of headings: 0 is NORTH, 1 is EAST, 2 is SOUTH, 3 is WEST
+    int heading;
+    // The heading the Pledge algorithm walks in whenever it isn't following a wall
+    int preferredHeading;
+    // The Pledge algorithm's running total of quarter turns. Right turns count +1, left turns -1.
+    int turnSum;
+    long long steps;
+};
+
+struct followerReport {
+    bool found;
+    long long steps;
+    double cellsPerSecond;
+    long peakMemoryKb;
+};
+
+followerState startAt(const XY& startLoc, const XY& endLoc);
+void nextStep(const cellReader& cells, const XY& target, const constants::wallFollowerRule rule, followerState& state);
+followerReport solve(const cellReader& cells,
+                     const XY& startLoc,
+                     const XY& endLoc,
+                     const constants::wallFollowerRule rule,
+                     pp::packedPath* route = nullptr);
+void animateSolution(const gridType& grid, const constants::wallFollowerRule rule);
+
+void _solverDraw(wl::wallLayer& walls, const followerState& state);
+
+}  // namespace wf
+
+#endif /* WALL_FOLLOWER_H */
@@ -1,27 +1,22 @@
 #ifndef WEIGHTED_SOLVER_H
 #define WEIGHTED_SOLVER_H
 
-#include <deque>
 #include "../../lib/raylib.h"
+#include "../packed_path.h"
+#include "../step_generator.h"
 #include "../utils.h"
-#include "map"
-#include "unordered_set"
+#include "solver_trace.h"
 
 using namespace utils;
 
 namespace ws {
 
-// Scores (as keys) for cells (as values) for all cells that have not yet been visited.
-typedef std::map<int, std::unordered_set<XY>> tScores;
-
-bool nextStep(const gridType& grid, const XY& target, tScores& remainingScores);
-int calculateScore(const XY& cell, const XY& mazeFinish);
-XY popBestScorer(tScores& remainingScores);
 void animateSolution(const gridType& grid);
-void insertIntoScores(const XY& cell, const int score, tScores& remainingScores);
-void solve(const gridType& grid, const XY& startLoc, const XY& endLoc);
+void reset();
+pp::packedPath solve(const gridType& grid, const XY& startLoc, const XY& endLoc);
+sg::generator<st::stepEvent> steps(const gridType& grid, const XY& startLoc, const XY& endLoc);
+int visitedCount();
 
-void _solverDraw(const gridType& grid, const int locationIdx);
 }  // namespace ws
 
 #endif /* WEIGHTED_SOLVER_H */
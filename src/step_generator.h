@@ -0,0 +1,118 @@
+#ifndef STEP_GENERATOR_H
+#define STEP_GENERATOR_H
+
+// A coroutine which lazily yields a sequence of values, to be iterated over with a range-based for loop, e.g.
+//
+//     sg::generator<int> countTo(int n) {
+//         for (int i = 1; i <= n; i++) co_yield i;
+//     }
+//
+// This is std::generator where the standard library provides it. Otherwise (e.g. GCC 12) it's the minimal stand-in
+// below, which only supports what this project needs: yielding values of one type, and iterating over them once.
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if __cpp_lib_generator
+#include <generator>
+
+namespace sg {
+template <typename T>
+using generator = std::generator<T>;
+}  // namespace sg
+
+#else
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace sg {
+
+template <typename T>
+class generator {
+   public:
+    struct promise_type {
+        // Points at the most recently yielded value, which lives in the coroutine until it's resumed
+        const T* current = nullptr;
+        std::exception_ptr exception;
+
+        generator get_return_object() { return generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = std::addressof(value);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() { exception = std::current_exception(); }
+        // Yielding is the only way to produce values
+        void await_transform() = delete;
+    };
+
+    class iterator {
+       public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+
+        iterator() = default;
+        explicit iterator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+        const T& operator*() const { return *coroutine.promise().current; }
+        iterator& operator++() {
+            resume(coroutine);
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return !coroutine || coroutine.done(); }
+
+       private:
+        std::coroutine_handle<promise_type> coroutine = nullptr;
+    };
+
+    generator(generator&& other) noexcept : coroutine(std::exchange(other.coroutine, nullptr)) {}
+    generator& operator=(generator&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            coroutine = std::exchange(other.coroutine, nullptr);
+        }
+        return *this;
+    }
+    ~generator() { destroy(); }
+
+    // Runs the coroutine up to its first yield. Only call this once.
+    iterator begin() {
+        resume(coroutine);
+        return iterator(coroutine);
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+   private:
+    std::coroutine_handle<promise_type> coroutine = nullptr;
+
+    explicit generator(std::coroutine_handle<promise_type> coroutine) : coroutine(coroutine) {}
+
+    // Run the coroutine up to its next yield, rethrowing anything it threw
+    static void resume(std::coroutine_handle<promise_type> coroutine) {
+        coroutine.resume();
+        if (coroutine.promise().exception) {
+            std::rethrow_exception(std::exchange(coroutine.promise().exception, nullptr));
+        }
+    }
+
+    void destroy() {
+        if (coroutine) {
+            coroutine.destroy();
+        }
+    }
+};
+
+}  // namespace sg
+
+#endif /* __cpp_lib_generator */
+
+#endif /* STEP_GENERATOR_H */
@@ -1,7 +1,15 @@
 #include "utils.h"
+#include <sys/resource.h>
+#include <unistd.h>
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <random>
+#include <stdexcept>
 #include <vector>
 #include "cassert"
 #include "constants.cpp"
@@ -25,13 +33,14 @@ gridType createEmptyGrid(const int rows, const int cols) {
             grid[y].push_back(0);
         }
     }
+    bumpGridGeneration();
     return grid;
 }
 
-// Return the minimum X and Y pixel dimensions required by the grid
+// Return the minimum X and Y pixel dimensions required by the grid, up to the largest window allowed
 canvasDims calculateCanvasDimensions() {
-    int x = COLS * CELLWIDTH;
-    int y = ROWS * CELLHEIGHT;
+    int x = std::min(COLS * CELLWIDTH, MAX_WINDOW_WIDTH);
+    int y = std::min(ROWS * CELLHEIGHT, MAX_WINDOW_HEIGHT);
     return canvasDims{x, y};
 }
 
@@ -68,6 +77,157 @@ bool inBounds(const gridType& grid, const XY& location) {
     return location.y < grid.size() && location.x < grid[0].size();
 }
 
+// Return the absolute index of a location, i.e. its position when the grid's rows are laid end to end
+int cellIndex(const gridType& grid, const XY& location) {
+    return location.y * grid[0].size() + location.x;
+}
+
+// Return the location one step away from the origin in the given direction. No bounds checks are performed.
+XY neighborOf(const XY& origin, const int direction) {
+    switch (direction) {
+        case NORTH:
+            return {origin.x, origin.y - 1};
+        case SOUTH:
+            return {origin.x, origin.y + 1};
+        case EAST:
+            return {origin.x + 1, origin.y};
+        case WEST:
+            return {origin.x - 1, origin.y};
+        default:
+            assert(false && "direction must be one of NORTH, SOUTH, EAST or WEST");
+            return origin;
+    }
+}
+
+// Return the direction of the step from one cell to the other, which must be next to it
+int directionTo(const XY& from, const XY& to) {
+    const int dx = to.x - from.x;
+    const int dy = to.y - from.y;
+    if (std::abs(dx) + std::abs(dy) != 1)
+        throw std::invalid_argument("Consecutive cells of a path must be next to each other");
+    // NORTH, SOUTH, EAST and WEST are the bits 0 to 3, in that order
+    const int horizontal = dx != 0;
+    return 1 << (2 * horizontal + ((dx + dy < 0) ^ (1 - horizontal)));
+}
+
+// Return the direction opposite to the given one. Equivalent to OPPOSITE[direction], without the map lookup.
+int oppositeOf(const int direction) {
+    // NORTH/SOUTH and EAST/WEST are pairs of adjacent bits
+    return (direction == NORTH || direction == EAST) ? direction << 1 : direction >> 1;
+}
+
+// Check if there is no wall between the origin and its neighbor in the given direction. That's the case when either
+// cell points to the other. Neighbors outside the grid are never connected.
+bool isConnected(const gridType& grid, const XY& origin, const int direction) {
+    const XY neighbor = neighborOf(origin, direction);
+    if (neighbor.x < 0 || neighbor.y < 0 || !inBounds(grid, neighbor)) {
+        return false;
+    }
+    return ((grid[origin.y][origin.x] & direction) != 0) ||
+           ((grid[neighbor.y][neighbor.x] & oppositeOf(direction)) != 0);
+}
+
+// Check if there is no wall between the origin and its neighbor in the given direction, reading cells on demand.
+bool isConnected(const cellReader& cells, const XY& origin, const int direction) {
+    const XY neighbor = neighborOf(origin, direction);
+    if (neighbor.x < 0 || neighbor.y < 0 || neighbor.x >= cells.cols || neighbor.y >= cells.rows) {
+        return false;
+    }
+    return ((cells.at(origin.x, origin.y) & direction) != 0) ||
+           ((cells.at(neighbor.x, neighbor.y) & oppositeOf(direction)) != 0);
+}
+
+// Return a cellReader which reads from the grid. The grid must outlive the reader.
+cellReader readerFor(const gridType& grid) {
+    auto read = [](const void* source, int x, int y) { return (*static_cast<const gridType*>(source))[y][x]; };
+    return cellReader{(int)grid.size(), (int)grid.at(0).size(), &grid, read};
+}
+
+// Return the largest amount of memory this process has held in RAM at any one time, in kilobytes
+long peakResidentMemoryKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Return the amount of memory this process holds in RAM now, in kilobytes. Where that can't be read from /proc, return
+// the peak instead.
+long residentMemoryKb() {
+    std::ifstream statm("/proc/self/statm");
+    long sizePages = 0;
+    long residentPages = 0;
+    if (statm >> sizePages >> residentPages) {
+        return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+    return peakResidentMemoryKb();
+}
+
+// Counts changes to the walls of any grid, so that results computed from a grid can tell whether they're still current
+static std::atomic<unsigned long long> g_gridGeneration = 0;
+
+// Note that some grid's walls have changed, or that a grid has been created. setWall, createEmptyGrid and the
+// generators call this; anything which changes a grid's cells directly should too.
+void bumpGridGeneration() {
+    g_gridGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Return a number which changes whenever any grid's walls may have changed
+unsigned long long gridGeneration() {
+    return g_gridGeneration.load(std::memory_order_relaxed);
+}
+
+// The listeners registered through addWallListener, keyed by the ids handed out to them
+static std::map<int, wallListener> g_wallListeners = {};
+static int g_nextListenerId = 0;
+// Listeners may be added and removed from any thread, so the map is only touched while holding this
+static std::mutex g_wallListenersMutex;
+
+// Register a function to be called after every wall edit made through setWall. Returns an id for removing it again.
+int addWallListener(wallListener listener) {
+    std::lock_guard<std::mutex> lock(g_wallListenersMutex);
+    g_wallListeners.emplace(g_nextListenerId, std::move(listener));
+    return g_nextListenerId++;
+}
+
+void removeWallListener(const int listenerId) {
+    std::lock_guard<std::mutex> lock(g_wallListenersMutex);
+    g_wallListeners.erase(listenerId);
+}
+
+// Open or close the wall between the origin and its neighbor in the given direction, then notify the wall listeners.
+// Nothing happens if the wall is already in the requested state.
+void setWall(gridType& grid, const XY& origin, const int direction, const bool open) {
+    const XY neighbor = neighborOf(origin, direction);
+    if (neighbor.x < 0 || neighbor.y < 0 || !inBounds(grid, neighbor) || !inBounds(grid, origin)) {
+        throw std::invalid_argument("Both sides of a wall must be within the grid");
+    }
+    if (isConnected(grid, origin, direction) == open) {
+        return;
+    }
+
+    if (open) {
+        grid[origin.y][origin.x] |= direction;
+    } else {
+        // Either cell may have been pointing to the other
+        grid[origin.y][origin.x] &= ~direction;
+        grid[neighbor.y][neighbor.x] &= ~oppositeOf(direction);
+    }
+    bumpGridGeneration();
+    // Call a copy of the listeners, without holding the lock, so that a listener can add or remove listeners, itself
+    // included. A listener removed on another thread meanwhile may still be called this once.
+    std::vector<wallListener> listeners = {};
+    {
+        std::lock_guard<std::mutex> lock(g_wallListenersMutex);
+        listeners.reserve(g_wallListeners.size());
+        for (const auto& [_id, listener] : g_wallListeners) {
+            listeners.push_back(listener);
+        }
+    }
+    for (const wallListener& listener : listeners) {
+        listener(grid, origin, neighbor);
+    }
+}
+
 // Apply a function to return a color between the start and target colors
 // TODO: determine how this does / should handle negatives
 // TODO: rework documentation and signature to make usage/purpose more obvious
@@ -102,7 +262,7 @@ Color gradateColor(Color start, Color target, int idx, int maxIdx) {
 // TODO: document, and mention bounds checks
 std::vector<XY> returnConnectedNeighbors(const gridType& grid,
                                          const XY& origin,
-                                         std::unordered_set<int> g_indicesChecked) {
+                                         const std::unordered_set<int>& g_indicesChecked) {
     std::vector<int> directions = {NORTH, SOUTH, EAST, WEST};
     std::random_device rd;
     std::mt19937 g(rd());
@@ -1,6 +1,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <functional>
 #include <unordered_set>
 #include <vector>
 #include "../lib/raylib.h"
@@ -30,16 +31,46 @@ struct canvasDims {
     int y;
 };
 
+// Read-only access to a maze's cells, one cell at a time. Code which reads cells through this never needs the whole
+// grid in memory, so the cells may just as well come from a gridType as from a memory-mapped file.
+struct cellReader {
+    int rows;
+    int cols;
+    // Whatever holds the cells, e.g. a gridType
+    const void* source;
+    // Return the value of the cell at x, y in the source. The location must be in bounds.
+    int (*read)(const void* source, int x, int y);
+
+    int at(const int x, const int y) const { return read(source, x, y); }
+};
+
+// Called whenever a wall is opened or closed through setWall. The two locations are the cells on either side of it.
+typedef std::function<void(const gridType& grid, const XY& a, const XY& b)> wallListener;
+
 // Function declarations
+int addWallListener(wallListener listener);
+void bumpGridGeneration();
 Color gradateColor(Color start, Color target, int idx, int maxIdx);
+int directionTo(const XY& from, const XY& to);
 bool inBounds(const gridType& grid, const XY& location);
 bool inBounds(const gridType& grid, const int x, const int y);
 canvasDims calculateCanvasDimensions();
 gridType createEmptyGrid(const int rows, const int cols);
+unsigned long long gridGeneration();
+int cellIndex(const gridType& grid, const XY& location);
 void displayMazeInConsole(gridType& grid);
+bool isConnected(const gridType& grid, const XY& origin, const int direction);
+bool isConnected(const cellReader& cells, const XY& origin, const int direction);
+XY neighborOf(const XY& origin, const int direction);
+int oppositeOf(const int direction);
+long peakResidentMemoryKb();
+long residentMemoryKb();
+cellReader readerFor(const gridType& grid);
+void removeWallListener(const int listenerId);
 std::vector<XY> returnConnectedNeighbors(const gridType& grid,
                                          const XY& origin,
-                                         std::unordered_set<int> g_indicesChecked);
+                                         const std::unordered_set<int>& g_indicesChecked);
+void setWall(gridType& grid, const XY& origin, const int direction, const bool open);
 
 }  // namespace utils
 
@@ -0,0 +1,284 @@
+// Stream headless frames into a single video file, rather than one image per frame. Most frames of an animation only
+// change a cell or two, and the animation marks which, so only the rectangle around them is converted into the
+// video's colors and, for GIF, encoded. Nothing compares whole frames to find what changed.
+
+#include "video_export.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+// GIF's LZW codes start one bit wider than the pixels, and never grow past 12 bits
+static const int GIF_PIXEL_BITS = 8;
+static const int GIF_CLEAR_CODE = 1 << GIF_PIXEL_BITS;
+static const int GIF_END_CODE = GIF_CLEAR_CODE + 1;
+static const int GIF_LAST_CODE = 4095;
+// The size of the hash table mapping (code, pixel) pairs to codes. Twice the number of codes keeps probing short.
+static const int LZW_TABLE_BITS = 13;
+static const int LZW_TABLE_SIZE = 1 << LZW_TABLE_BITS;
+// The palette holds every combination of this many levels of red, green and blue: 252 colors
+static const int RED_LEVELS = 6;
+static const int GREEN_LEVELS = 7;
+static const int BLUE_LEVELS = 6;
+
+static void writeShort(std::ostream& out, const int value) {
+    out.put((char)(value & 0xFF));
+    out.put((char)((value >> 8) & 0xFF));
+}
+
+// The index of the palette color nearest to the given color
+static std::uint8_t paletteIndex(const Color color) {
+    const int red = (color.r * (RED_LEVELS - 1) + 127) / 255;
+    const int green = (color.g * (GREEN_LEVELS - 1) + 127) / 255;
+    const int blue = (color.b * (BLUE_LEVELS - 1) + 127) / 255;
+    return (red * GREEN_LEVELS + green) * BLUE_LEVELS + blue;
+}
+
+// Packs codes of varying widths into bytes, least significant bit first, and writes the bytes in GIF's sub-blocks of up
+// to 255 bytes each
+struct codeWriter {
+    std::ostream& out;
+    std::uint32_t bits = 0;
+    int bitCount = 0;
+    char block[255] = {};
+    int blockSize = 0;
+
+    void write(const int code, const int codeSize) {
+        bits |= (std::uint32_t)code << bitCount;
+        bitCount += codeSize;
+        while (bitCount >= 8) {
+            push(bits & 0xFF);
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+    void push(const std::uint8_t byte) {
+        block[blockSize++] = (char)byte;
+        if (blockSize == sizeof(block)) {
+            flushBlock();
+        }
+    }
+    void flushBlock() {
+        if (blockSize > 0) {
+            out.put((char)blockSize);
+            out.write(block, blockSize);
+            blockSize = 0;
+        }
+    }
+    // Write out any bits left over, and the empty block which ends the image's data
+    void finish() {
+        if (bitCount > 0) {
+            push(bits & 0xFF);
+        }
+        flushBlock();
+        out.put(0);
+    }
+};
+
+// Compress the palette indices of an image's pixels with GIF's variant of LZW, and write them as the image's data.
+// Each code stands for a run of pixels seen before, extended by one. Once every code is used, the table is cleared.
+static void writeLzw(std::ostream& out, const std::vector<std::uint8_t>& pixels) {
+    out.put(GIF_PIXEL_BITS);
+    codeWriter writer = {out};
+    // Each slot holds a key, (code << 8 | pixel), or -1 if empty, and the code for that run of pixels
+    std::vector<std::int32_t> keys(LZW_TABLE_SIZE, -1);
+    std::vector<std::uint16_t> codes(LZW_TABLE_SIZE);
+    int codeSize = GIF_PIXEL_BITS + 1;
+    int lastCode = GIF_END_CODE;
+    writer.write(GIF_CLEAR_CODE, codeSize);
+
+    int current = pixels[0];
+    for (std::size_t i = 1; i < pixels.size(); i++) {
+        const int pixel = pixels[i];
+        const std::int32_t key = current << GIF_PIXEL_BITS | pixel;
+        std::uint32_t slot = ((std::uint32_t)key * 2654435761u) >> (32 - LZW_TABLE_BITS);
+        while (keys[slot] != -1 && keys[slot] != key) {
+            slot = (slot + 1) & (LZW_TABLE_SIZE - 1);
+        }
+        if (keys[slot] == key) {
+            current = codes[slot];
+            continue;
+        }
+
+        writer.write(current, codeSize);
+        lastCode++;
+        keys[slot] = key;
+        codes[slot] = lastCode;
+        if (lastCode >= (1 << codeSize)) {
+            codeSize++;
+        }
+        if (lastCode == GIF_LAST_CODE) {
+            writer.write(GIF_CLEAR_CODE, codeSize);
+            std::fill(keys.begin(), keys.end(), -1);
+            codeSize = GIF_PIXEL_BITS + 1;
+            lastCode = GIF_END_CODE;
+        }
+        current = pixel;
+    }
+    writer.write(current, codeSize);
+    writer.write(GIF_CLEAR_CODE, codeSize);
+    writer.write(GIF_END_CODE, GIF_PIXEL_BITS + 1);
+    writer.finish();
+}
+
+static void writeY4mHeader(vx::videoStream& stream) {
+    char header[64];
+    const int length = std::snprintf(header, sizeof(header), "YUV4MPEG2 W%i H%i F%i:1 Ip A1:1 C420jpeg\n",
+                                     stream.width, stream.height, stream.fps);
+    stream.file.write(header, length);
+}
+
+// Convert the pixels in rect into the Y plane, and the 2x2 blocks they fall in into the Cb and Cr planes, with the
+// full-range BT.601 coefficients which JPEG uses. The rest of the planes still hold earlier frames' unchanged pixels.
+static void convertToYuv(vx::videoStream& stream, const rd::canvas& frame, const rd::frameRect& rect) {
+    const int chromaWidth = (stream.width + 1) / 2;
+    const int chromaHeight = (stream.height + 1) / 2;
+    std::uint8_t* luma = stream.planes.data();
+    std::uint8_t* blue = luma + (std::size_t)stream.width * stream.height;
+    std::uint8_t* red = blue + (std::size_t)chromaWidth * chromaHeight;
+    for (int y = rect.top; y < rect.bottom; y++) {
+        const Color* row = frame.pixels.data() + (std::size_t)y * stream.width;
+        for (int x = rect.left; x < rect.right; x++) {
+            const Color pixel = row[x];
+            luma[(std::size_t)y * stream.width + x] = (77 * pixel.r + 150 * pixel.g + 29 * pixel.b + 128) >> 8;
+        }
+    }
+    for (int blockY = rect.top / 2; blockY < (rect.bottom + 1) / 2; blockY++) {
+        for (int blockX = rect.left / 2; blockX < (rect.right + 1) / 2; blockX++) {
+            int r = 0, g = 0, b = 0, count = 0;
+            for (int y = blockY * 2; y < std::min(blockY * 2 + 2, stream.height); y++) {
+                for (int x = blockX * 2; x < std::min(blockX * 2 + 2, stream.width); x++) {
+                    const Color pixel = frame.pixels[(std::size_t)y * stream.width + x];
+                    r += pixel.r;
+                    g += pixel.g;
+                    b += pixel.b;
+                    count++;
+                }
+            }
+            r /= count;
+            g /= count;
+            b /= count;
+            const std::size_t idx = (std::size_t)blockY * chromaWidth + blockX;
+            blue[idx] = std::clamp((-43 * r - 85 * g + 128 * b + 128) / 256 + 128, 0, 255);
+            red[idx] = std::clamp((128 * r - 107 * g - 21 * b + 128) / 256 + 128, 0, 255);
+        }
+    }
+}
+
+// Y4M frames can't leave anything out, so the whole of the planes is written, however little changed
+static void writeY4mFrame(vx::videoStream& stream, const rd::canvas& frame, const rd::frameRect& rect) {
+    convertToYuv(stream, frame, rect);
+    stream.file.write("FRAME\n", 6);
+    stream.file.write((const char*)stream.planes.data(), stream.planes.size());
+}
+
+// Write the GIF's header, its palette, and the extension which makes it loop forever
+static void writeGifHeader(vx::videoStream& stream) {
+    std::ostream& out = stream.file;
+    out.write("GIF89a", 6);
+    writeShort(out, stream.width);
+    writeShort(out, stream.height);
+    // A global palette of 256 colors, 8 bits per primary
+    out.put((char)0xF7);
+    out.put(0);
+    out.put(0);
+    for (int i = 0; i < 256; i++) {
+        const bool used = i < RED_LEVELS * GREEN_LEVELS * BLUE_LEVELS;
+        const int red = i / (GREEN_LEVELS * BLUE_LEVELS);
+        const int green = i / BLUE_LEVELS % GREEN_LEVELS;
+        const int blue = i % BLUE_LEVELS;
+        out.put(used ? (char)(red * 255 / (RED_LEVELS - 1)) : 0);
+        out.put(used ? (char)(green * 255 / (GREEN_LEVELS - 1)) : 0);
+        out.put(used ? (char)(blue * 255 / (BLUE_LEVELS - 1)) : 0);
+    }
+    out.write("\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00", 19);
+}
+
+// Write the pixels in rect as an image drawn over the frames before it. GIF can't show a frame which changes nothing,
+// so one pixel is written again to keep the frame's time.
+static void writeGifFrame(vx::videoStream& stream, const rd::canvas& frame, rd::frameRect rect) {
+    if (rect.right <= rect.left) {
+        rect = {0, 0, 1, 1};
+    }
+    std::ostream& out = stream.file;
+    // Keep the frame in place under the next one, and show it for 1/fps seconds, in hundredths. Most viewers slow
+    // down delays shorter than 2.
+    const int delay = std::max(2, (int)std::lround(100.0 / stream.fps));
+    out.write("\x21\xF9\x04\x04", 4);
+    writeShort(out, delay);
+    out.put(0);
+    out.put(0);
+
+    out.put(0x2C);
+    writeShort(out, rect.left);
+    writeShort(out, rect.top);
+    writeShort(out, rect.right - rect.left);
+    writeShort(out, rect.bottom - rect.top);
+    out.put(0);
+    std::vector<std::uint8_t> indices;
+    indices.reserve((std::size_t)(rect.right - rect.left) * (rect.bottom - rect.top));
+    for (int y = rect.top; y < rect.bottom; y++) {
+        const Color* row = frame.pixels.data() + (std::size_t)y * stream.width;
+        for (int x = rect.left; x < rect.right; x++) {
+            indices.push_back(paletteIndex(row[x]));
+        }
+    }
+    writeLzw(out, indices);
+}
+
+// Open a video file to write frames of the given size into, in the format chosen by the path's extension: GIF for
+// ".gif", and Y4M otherwise. Returns true on success.
+bool vx::open(videoStream& stream, const char* path, const int width, const int height, const int fps) {
+    const std::string name = path;
+    stream.format = name.ends_with(".gif") ? GIF_FORMAT : Y4M_FORMAT;
+    stream.width = width;
+    stream.height = height;
+    stream.fps = std::max(1, fps);
+    stream.planes.clear();
+    stream.frameCount = 0;
+    if (stream.format == GIF_FORMAT && (width > 0xFFFF || height > 0xFFFF)) {
+        return false;
+    }
+    stream.file.open(path, std::ios::binary | std::ios::trunc);
+    if (!stream.file) {
+        return false;
+    }
+    if (stream.format == Y4M_FORMAT) {
+        const std::size_t chromaSize = (std::size_t)((width + 1) / 2) * ((height + 1) / 2);
+        stream.planes.assign((std::size_t)width * height + 2 * chromaSize, 0);
+        writeY4mHeader(stream);
+    } else {
+        writeGifHeader(stream);
+    }
+    return (bool)stream.file;
+}
+
+// Append a frame, which must be the size the stream was opened with. Only the changed rectangle may differ from the
+// frame written before; the rest is taken to be the same. The first frame is written whole.
+void vx::writeFrame(videoStream& stream, const rd::canvas& frame, const rd::frameRect& changed) {
+    if (frame.width != stream.width || frame.height != stream.height) {
+        throw std::invalid_argument("frame size doesn't match the video's");
+    }
+    rd::frameRect rect = {std::max(changed.left, 0), std::max(changed.top, 0), std::min(changed.right, stream.width),
+                          std::min(changed.bottom, stream.height)};
+    if (stream.frameCount == 0) {
+        rect = {0, 0, stream.width, stream.height};
+    } else if (rect.right <= rect.left || rect.bottom <= rect.top) {
+        rect = {0, 0, 0, 0};
+    }
+    if (stream.format == Y4M_FORMAT) {
+        writeY4mFrame(stream, frame, rect);
+    } else {
+        writeGifFrame(stream, frame, rect);
+    }
+    stream.frameCount++;
+}
+
+void vx::close(videoStream& stream) {
+    if (stream.file.is_open() && stream.format == GIF_FORMAT) {
+        stream.file.put(0x3B);
+    }
+    stream.file.close();
+    stream.planes = {};
+}
@@ -0,0 +1,36 @@
+#ifndef VIDEO_EXPORT_H
+#define VIDEO_EXPORT_H
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include "render.h"
+
+namespace vx {
+
+// GIF plays anywhere, with its colors rounded to a fixed palette of 252, and each of its frames only holds the
+// rectangle which changed. Y4M is uncompressed YUV 4:2:0, which video tools read directly, e.g.
+// `ffmpeg -i animation.y4m animation.mp4`, but it has no way to leave pixels out, so every frame is written whole.
+enum videoFormat { Y4M_FORMAT, GIF_FORMAT };
+
+// A video being written one frame at a time. The caller says which rectangle of each frame changed, e.g. from
+// rd::dirtyRect, and only that is converted into the video's colors: a GIF frame holds nothing else, and a Y4M frame
+// reuses the rest of the previous frame's planes.
+struct videoStream {
+    std::ofstream file;
+    videoFormat format;
+    int width;
+    int height;
+    int fps;
+    // Y4M only: the Y plane, then the Cb and Cr planes at half the width and height
+    std::vector<std::uint8_t> planes;
+    long long frameCount;
+};
+
+bool open(videoStream& stream, const char* path, const int width, const int height, const int fps);
+void writeFrame(videoStream& stream, const rd::canvas& frame, const rd::frameRect& changed);
+void close(videoStream& stream);
+
+}  // namespace vx
+
+#endif /* VIDEO_EXPORT_H */
@@ -0,0 +1,82 @@
+// Pan and zoom around mazes too large for the window. The camera itself is kept by rd, which draws through it, so this
+// only moves it in response to the mouse and keyboard, and tells the drawing code which cells it can see. Drawing only
+// those keeps the cost of a frame down to the size of the window, however large the maze.
+
+#include "viewer.h"
+#include <algorithm>
+#include <cmath>
+#include "constants.cpp"
+#include "render.h"
+
+using namespace constants;
+
+// Move the camera in response to the mouse and keyboard. Call once per frame, before drawing it. Without a window
+// there's nothing to respond to, so the camera stays where it is.
+void vw::update() {
+    if (rd::isHeadless()) {
+        return;
+    }
+    Camera2D camera = rd::currentCamera();
+
+    if (IsKeyPressed(KEY_HOME)) {
+        reset();
+        return;
+    }
+
+    // Drag the maze along with the mouse
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+        const Vector2 delta = GetMouseDelta();
+        camera.target.x -= delta.x / camera.zoom;
+        camera.target.y -= delta.y / camera.zoom;
+    }
+    const int panX = IsKeyDown(KEY_RIGHT) - IsKeyDown(KEY_LEFT);
+    const int panY = IsKeyDown(KEY_DOWN) - IsKeyDown(KEY_UP);
+    camera.target.x += panX * PAN_SPEED / camera.zoom;
+    camera.target.y += panY * PAN_SPEED / camera.zoom;
+
+    // Zoom around the mouse, so that whatever is under it stays there
+    const float wheel = GetMouseWheelMove();
+    if (wheel != 0) {
+        const Vector2 mouse = GetMousePosition();
+        camera.target = GetScreenToWorld2D(mouse, camera);
+        camera.offset = mouse;
+        camera.zoom = std::clamp(camera.zoom * std::pow(1.25f, wheel), MIN_ZOOM, MAX_ZOOM);
+    }
+    rd::useCamera(camera);
+}
+
+// Show the maze at its own size, with its top left corner at the frame's
+void vw::reset() {
+    rd::useCamera({{0, 0}, {0, 0}, 0, 1});
+}
+
+// Return the cells which the camera shows at least part of, including the walls around them
+vw::cellRange vw::visibleCells(const int rows, const int cols) {
+    const Camera2D& camera = rd::currentCamera();
+    const double left = camera.target.x - camera.offset.x / camera.zoom;
+    const double top = camera.target.y - camera.offset.y / camera.zoom;
+    const double right = left + rd::frameWidth() / camera.zoom;
+    const double bottom = top + rd::frameHeight() / camera.zoom;
+    // Walls are drawn at least one pixel thick, so those of the cells just outside the view may reach into it
+    return {std::clamp((int)std::floor(left / CELLWIDTH) - 1, 0, cols),
+            std::clamp((int)std::floor(top / CELLHEIGHT) - 1, 0, rows),
+            std::clamp((int)std::floor(right / CELLWIDTH) + 1, 0, cols),
+            std::clamp((int)std::floor(bottom / CELLHEIGHT) + 1, 0, rows)};
+}
+
+// Return 0 while a cell covers at least a pixel through the camera. Otherwise, return the level of the overview (see
+// overview.h) whose blocks of cells do.
+int vw::detailLevel() {
+    int level = 0;
+    const float zoom = rd::currentCamera().zoom;
+    for (float cellPixels = zoom * std::min(CELLWIDTH, CELLHEIGHT); cellPixels < 1 && zoom > 0; cellPixels *= 2) {
+        level++;
+    }
+    return level;
+}
+
+// Whether two cameras show the same thing, so that what was drawn through one needn't be drawn again for the other
+bool vw::sameView(const Camera2D& a, const Camera2D& b) {
+    return a.target.x == b.target.x && a.target.y == b.target.y && a.offset.x == b.offset.x &&
+           a.offset.y == b.offset.y && a.zoom == b.zoom;
+}
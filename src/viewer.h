@@ -0,0 +1,24 @@
+#ifndef VIEWER_H
+#define VIEWER_H
+
+#include "../lib/raylib.h"
+
+namespace vw {
+
+// A block of cells, from (minX, minY) up to but not including (maxX, maxY)
+struct cellRange {
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+};
+
+void update();
+void reset();
+cellRange visibleCells(const int rows, const int cols);
+int detailLevel();
+bool sameView(const Camera2D& a, const Camera2D& b);
+
+}  // namespace vw
+
+#endif /* VIEWER_H */
@@ -0,0 +1,133 @@
+// Merge a maze's walls into the longest straight segments they form, for drawing and for vector export.
+
+#include "wall_geometry.h"
+#include <algorithm>
+#include <stdexcept>
+#include "constants.cpp"
+
+using namespace constants;
+
+// Append the runs of walls along one grid line, between the cells at first and last - 1, to spans. hasWall(i) says
+// whether there's a wall at the i'th cell of the line.
+template <typename HasWall>
+static void scanLine(const int first, const int last, HasWall&& hasWall, std::vector<wg::span>& spans) {
+    for (int i = first; i < last;) {
+        if (!hasWall(i)) {
+            i++;
+            continue;
+        }
+        const int start = i;
+        while (i < last && hasWall(i)) {
+            i++;
+        }
+        spans.push_back({start, i});
+    }
+}
+
+// Take the wall at the given position out of the span holding it, splitting the span in two if the wall was in its
+// middle. Does nothing if there's no wall there.
+static void removeFromLine(std::vector<wg::span>& spans, const int position) {
+    // The last span starting at or before the position
+    auto holder = std::upper_bound(spans.begin(), spans.end(), position,
+                                   [](const int value, const wg::span& walls) { return value < walls.start; });
+    if (holder == spans.begin() || (holder - 1)->end <= position) {
+        return;
+    }
+    --holder;
+    const wg::span after = {position + 1, holder->end};
+    holder->end = position;
+    if (holder->start == holder->end) {
+        holder = spans.erase(holder);
+    } else {
+        ++holder;
+    }
+    if (after.start < after.end) {
+        spans.insert(holder, after);
+    }
+}
+
+static void writeColor(std::ostream& out, const Color color) {
+    out << "rgb(" << (int)color.r << ',' << (int)color.g << ',' << (int)color.b << ')';
+}
+
+// Find the maximal straight segments of wall in the grid
+wg::wallGeometry wg::build(const gridType& grid) {
+    return build(grid, {0, 0}, {(int)grid.at(0).size(), (int)grid.size()});
+}
+
+// Find the maximal straight segments of the walls owned by the cells from the given one up to, but not including, the
+// cell at to, e.g. only those which can be seen. Segments are cut short at the edges of the block.
+wg::wallGeometry wg::build(const gridType& grid, const XY& from, const XY& to) {
+    const int rows = grid.size();
+    const int cols = grid.at(0).size();
+    wallGeometry geometry = {rows, cols, std::vector<std::vector<span>>(rows + 1),
+                             std::vector<std::vector<span>>(cols + 1)};
+    for (int y = from.y; y < to.y; y++) {
+        scanLine(from.x, to.x, [&](const int x) { return !isConnected(grid, {x, y}, SOUTH); },
+                 geometry.horizontal[y + 1]);
+    }
+    for (int x = from.x; x < to.x; x++) {
+        scanLine(from.y, to.y, [&](const int y) { return !isConnected(grid, {x, y}, EAST); },
+                 geometry.vertical[x + 1]);
+    }
+    return geometry;
+}
+
+// Update the geometry after the wall on the given side of the cell has been removed from the maze. Walls along the
+// north and west edges of the maze aren't part of the geometry, so removing them does nothing.
+void wg::removeWall(wallGeometry& geometry, const XY& cell, const int direction) {
+    if (cell.x < 0 || cell.y < 0 || cell.x >= geometry.cols || cell.y >= geometry.rows)
+        throw std::invalid_argument("The cell is outside of the maze");
+
+    switch (direction) {
+        case NORTH:
+            removeFromLine(geometry.horizontal[cell.y], cell.x);
+            break;
+        case SOUTH:
+            removeFromLine(geometry.horizontal[cell.y + 1], cell.x);
+            break;
+        case WEST:
+            removeFromLine(geometry.vertical[cell.x], cell.y);
+            break;
+        case EAST:
+            removeFromLine(geometry.vertical[cell.x + 1], cell.y);
+            break;
+        default:
+            throw std::invalid_argument("Invalid direction");
+    }
+}
+
+// Return the number of segments, i.e. the number of lines it takes to draw the walls
+std::size_t wg::segmentCount(const wallGeometry& geometry) {
+    std::size_t count = 0;
+    for (const auto& spans : geometry.horizontal) {
+        count += spans.size();
+    }
+    for (const auto& spans : geometry.vertical) {
+        count += spans.size();
+    }
+    return count;
+}
+
+// Write the walls as an SVG image, with one path holding every segment
+void wg::writeSvg(const wallGeometry& geometry, std::ostream& out, const int cellWidth, const int cellHeight,
+                  const Color background, const Color wall) {
+    const int width = geometry.cols * cellWidth + 1;
+    const int height = geometry.rows * cellHeight + 1;
+    out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height
+        << "\" viewBox=\"0 0 " << width << ' ' << height << "\" shape-rendering=\"crispEdges\">\n";
+    out << "<rect width=\"100%\" height=\"100%\" fill=\"";
+    writeColor(out, background);
+    out << "\"/>\n<path fill=\"none\" stroke-width=\"1\" stroke=\"";
+    writeColor(out, wall);
+    out << "\" d=\"";
+    // Offset by half a pixel, so that each line covers the same pixels as in the window
+    forEachSegment(geometry, cellWidth, cellHeight, [&](const int x0, const int y0, const int x1, const int y1) {
+        if (y0 == y1) {
+            out << 'M' << x0 << ' ' << y0 + 0.5 << 'H' << x1;
+        } else {
+            out << 'M' << x0 + 0.5 << ' ' << y0 << 'V' << y1;
+        }
+    });
+    out << "\"/>\n</svg>\n";
+}
@@ -0,0 +1,58 @@
+#ifndef WALL_GEOMETRY_H
+#define WALL_GEOMETRY_H
+
+#include <ostream>
+#include <vector>
+#include "../lib/raylib.h"
+#include "utils.h"
+
+using namespace utils;
+
+namespace wg {
+
+// A run of walls along one grid line, from the corner at start up to the corner at end, in cells
+struct span {
+    int start;
+    int end;
+};
+
+// The walls of a maze, with walls which continue each other in a straight line merged into one segment. Long straight
+// walls are then drawn with one line each, rather than one per cell. As elsewhere, each cell owns the walls on its
+// east and south sides, so nothing lies along the north and west edges of the maze.
+struct wallGeometry {
+    int rows;
+    int cols;
+    // horizontal[y] holds the walls along the top edge of row y, i.e. the south walls of row y - 1, as spans of x.
+    // Sorted by start.
+    std::vector<std::vector<span>> horizontal;
+    // vertical[x] holds the walls along the left edge of column x, i.e. the east walls of column x - 1, as spans of y.
+    // Sorted by start.
+    std::vector<std::vector<span>> vertical;
+};
+
+wallGeometry build(const gridType& grid);
+wallGeometry build(const gridType& grid, const XY& from, const XY& to);
+void removeWall(wallGeometry& geometry, const XY& cell, const int direction);
+std::size_t segmentCount(const wallGeometry& geometry);
+void writeSvg(const wallGeometry& geometry, std::ostream& out, const int cellWidth, const int cellHeight,
+              const Color background, const Color wall);
+
+// Call visit(startX, startY, endX, endY) for each segment, in pixels, for cells of the given size. Horizontal segments
+// come first.
+template <typename Visitor>
+void forEachSegment(const wallGeometry& geometry, const int cellWidth, const int cellHeight, Visitor&& visit) {
+    for (int y = 0; y < (int)geometry.horizontal.size(); y++) {
+        for (const span& walls : geometry.horizontal[y]) {
+            visit(walls.start * cellWidth, y * cellHeight, walls.end * cellWidth, y * cellHeight);
+        }
+    }
+    for (int x = 0; x < (int)geometry.vertical.size(); x++) {
+        for (const span& walls : geometry.vertical[x]) {
+            visit(x * cellWidth, walls.start * cellHeight, x * cellWidth, walls.end * cellHeight);
+        }
+    }
+}
+
+}  // namespace wg
+
+#endif /* WALL_GEOMETRY_H */
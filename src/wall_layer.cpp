@@ -0,0 +1,90 @@
+// Draw a maze's walls once, and then only again where they change. The walls never change while a maze is solved, and
+// only around the most recently edited cells while it's generated, so redrawing every wall on every frame is wasted.
+
+#include "wall_layer.h"
+#include "constants.cpp"
+#include "viewer.h"
+#include "wall_geometry.h"
+
+using namespace constants;
+
+// Draw the walls on the east and south sides of the cell, if it has any. Expects the layer to be drawn into.
+static void drawWalls(const wl::wallLayer& layer, const int x, const int y) {
+    const gridType& grid = *layer.grid;
+    if (x < 0 || y < 0 || !inBounds(grid, x, y)) {
+        return;
+    }
+    if (!isConnected(grid, {x, y}, EAST)) {
+        rd::line((x + 1) * CELLWIDTH, y * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, layer.color);
+    }
+    if (!isConnected(grid, {x, y}, SOUTH)) {
+        rd::line(x * CELLWIDTH, (y + 1) * CELLHEIGHT, (x + 1) * CELLWIDTH, (y + 1) * CELLHEIGHT, layer.color);
+    }
+}
+
+// Draw every wall the camera shows into the layer, replacing what was there
+static void redrawVisible(wl::wallLayer& layer) {
+    const gridType& grid = *layer.grid;
+    const vw::cellRange visible = vw::visibleCells(grid.size(), grid.at(0).size());
+    rd::beginLayer(layer.walls);
+    rd::clear(BLANK);
+    // One line per straight run of walls, rather than one per cell. Lines cover the same pixels either way.
+    wg::forEachSegment(wg::build(grid, {visible.minX, visible.minY}, {visible.maxX, visible.maxY}), CELLWIDTH,
+                       CELLHEIGHT, [&](const int startX, const int startY, const int endX, const int endY) {
+                           rd::line(startX, startY, endX, endY, layer.color);
+                       });
+    rd::endLayer();
+    layer.drawnThrough = rd::currentCamera();
+}
+
+// Draw the walls of the grid which the camera shows into a new layer, the size of the frame, in the given color.
+// Expects an open window or canvas.
+wl::wallLayer wl::load(const gridType& grid, const Color color) {
+    wallLayer layer = {rd::loadLayer(rd::frameWidth(), rd::frameHeight()), color, &grid, rd::currentCamera(),
+                       ov::build(grid, OVERVIEW_THREADS)};
+    redrawVisible(layer);
+    return layer;
+}
+
+void wl::unload(wallLayer& layer) {
+    rd::unloadLayer(layer.walls);
+    layer.overview = {};
+}
+
+// Redraw the walls around the cell, after the grid has changed there
+void wl::redrawCell(wallLayer& layer, const XY& cell) {
+    if (cell.x < 0 || cell.y < 0 || !inBounds(*layer.grid, cell)) {
+        return;
+    }
+    ov::updateWalls(layer.overview, *layer.grid, cell);
+    // If the camera has moved, draw will redraw everything anyway
+    if (!vw::sameView(layer.drawnThrough, rd::currentCamera())) {
+        return;
+    }
+    rd::beginLayer(layer.walls);
+    // Clear the cell along with the walls around it, and then draw every wall which may cover part of that area again.
+    // That includes the neighbors' walls which only share a corner with it.
+    rd::erase(cell.x * CELLWIDTH, cell.y * CELLHEIGHT, CELLWIDTH + 1, CELLHEIGHT + 1);
+    for (int y = cell.y - 1; y <= cell.y + 1; y++) {
+        for (int x = cell.x - 1; x <= cell.x + 1; x++) {
+            drawWalls(layer, x, y);
+        }
+    }
+    rd::endLayer();
+}
+
+// Draw the walls into the frame, first drawing them again if the camera has moved. Zoomed out until cells are smaller
+// than a pixel, draw the overview instead, which covers the cells as well.
+void wl::draw(wallLayer& layer) {
+    const int detailLevel = vw::detailLevel();
+    if (detailLevel > 0) {
+        ov::draw(layer.overview, detailLevel, RAYWHITE, layer.color, cellFocusColor, overviewSolutionColor);
+        // Cells may change while zoomed out, so draw the walls again once zoomed back in, even at the same camera
+        layer.drawnThrough.zoom = 0;
+        return;
+    }
+    if (!vw::sameView(layer.drawnThrough, rd::currentCamera())) {
+        redrawVisible(layer);
+    }
+    rd::drawLayer(layer.walls, 0, 0);
+}
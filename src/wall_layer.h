@@ -0,0 +1,35 @@
+#ifndef WALL_LAYER_H
+#define WALL_LAYER_H
+
+#include "../lib/raylib.h"
+#include "overview.h"
+#include "render.h"
+#include "utils.h"
+
+using namespace utils;
+
+namespace wl {
+
+// The walls of a maze, drawn once into a layer, so that each frame draws the layer instead of every wall again.
+// Each cell owns the walls on its east and south sides, as in the rest of the drawing code, so no walls are drawn along
+// the north and west edges of the maze. The layer is the size of the frame, and holds only the walls the camera shows,
+// so they're drawn again whenever it moves. Zoomed out until cells are smaller than a pixel, the overview is drawn
+// instead, along with anything marked on it, e.g. by ov::markVisited.
+struct wallLayer {
+    rd::layer walls;
+    Color color;
+    // The grid must outlive the layer
+    const gridType* grid;
+    // The camera the walls were last drawn through
+    Camera2D drawnThrough;
+    ov::pyramid overview;
+};
+
+wallLayer load(const gridType& grid, const Color color);
+void unload(wallLayer& layer);
+void redrawCell(wallLayer& layer, const XY& cell);
+void draw(wallLayer& layer);
+
+}  // namespace wl
+
+#endif /* WALL_LAYER_H */
@@ -0,0 +1,497 @@
+#include <algorithm>
+#include <cassert>  // for assert
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include "../src/batch.h"
+#include "../src/constants.cpp"
+#include "../src/generators/recursive_backtracking.h"
+#include "../src/log.h"
+#include "../src/packed_path.h"
+#include "../src/render.h"
+#include "../src/solvers/a_star_solver.h"
+#include "../src/solvers/dead_end_filler.h"
+#include "../src/solvers/depth_first_solver.h"
+#include "../src/solvers/distance_field.h"
+#include "../src/solvers/hierarchical_solver.h"
+#include "../src/solvers/incremental_planner.h"
+#include "../src/solvers/junction_graph.h"
+#include "../src/solvers/landmarks.h"
+#include "../src/solvers/memory_bounded_solver.h"
+#include "../src/solvers/naive_recursive_solver.h"
+#include "../src/solvers/solver_trace.h"
+#include "../src/solvers/tree_path_index.h"
+#include "../src/solvers/wall_follower.h"
+#include "../src/solvers/weighted_proximity_recursive.h"
+#include "../src/utils.h"
+
+// Create a 3x3 perfect maze, whose only path from (0,0) to (2,2) snakes through the middle row.
+// The cells at (2,0) and (2,1) are dead ends.
+utils::gridType createSnakeMaze() {
+    auto grid = utils::createEmptyGrid(3, 3);
+    grid.at(0).at(0) = constants::EAST;
+    grid.at(0).at(1) = constants::EAST + constants::SOUTH;
+    grid.at(1).at(1) = constants::WEST;
+    grid.at(1).at(0) = constants::SOUTH;
+    grid.at(2).at(0) = constants::EAST;
+    grid.at(2).at(1) = constants::EAST;
+    grid.at(2).at(2) = constants::NORTH;
+    return grid;
+}
+
+const std::vector<utils::XY> SNAKE_MAZE_SOLUTION = {{0, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 2}, {1, 2}, {2, 2}};
+
+// The dead-end filler should leave exactly the solution corridor, regardless of the number of threads
+int testDeadEndFilling() {
+    const auto grid = createSnakeMaze();
+    for (int threads = 1; threads <= 3; threads++) {
+        const auto pruned = de::solve(grid, {0, 0}, {2, 2}, threads);
+        assert(pp::unpack(pruned.path) == SNAKE_MAZE_SOLUTION);
+
+        // The dead ends are walled off in the pruned maze, but the corridor is intact
+        assert(!utils::isConnected(pruned.grid, {2, 0}, constants::WEST));
+        assert(!utils::isConnected(pruned.grid, {2, 1}, constants::SOUTH));
+        assert(utils::isConnected(pruned.grid, {1, 1}, constants::WEST));
+    }
+
+    return 0;
+}
+
+// The breadth first and best first solvers only record the order of their visits, from which the path is recovered
+int testRecursiveSolverPaths() {
+    auto grid = createSnakeMaze();
+    ns::reset();
+    assert(pp::unpack(ns::solve(grid, {0, 0}, {2, 2})) == SNAKE_MAZE_SOLUTION);
+    ws::reset();
+    assert(pp::unpack(ws::solve(grid, {0, 0}, {2, 2})) == SNAKE_MAZE_SOLUTION);
+    ds::reset();
+    assert(pp::unpack(ds::solve(grid, {0, 0}, {2, 2})) == SNAKE_MAZE_SOLUTION);
+    as::reset();
+    assert(pp::unpack(as::solve(grid, {0, 0}, {2, 2})) == SNAKE_MAZE_SOLUTION);
+
+    // The dead end at (2,1) is only reachable from (2,2)
+    ns::reset();
+    const std::vector<utils::XY> intoDeadEnd = {{0, 1}, {0, 2}, {1, 2}, {2, 2}, {2, 1}};
+    assert(pp::unpack(ns::solve(grid, {0, 1}, {2, 1})) == intoDeadEnd);
+
+    // Solving again starts afresh, rather than continuing from the previous search
+    assert(pp::unpack(ds::solve(grid, {2, 2}, {0, 0})) == pp::unpack(pp::reversed(pp::pack(SNAKE_MAZE_SOLUTION))));
+    assert(ds::visitedCount() < 9);
+
+    ns::reset();
+    ws::reset();
+    ds::reset();
+    as::reset();
+    return 0;
+}
+
+// A trace decodes to exactly the visits recorded into it, across chunk boundaries
+int testSolveTrace() {
+    std::mt19937 rng(7);
+    auto grid = utils::createEmptyGrid(120, 120);
+    rb::generateMazeIteratively(&grid, rng);
+
+    std::vector<st::stepEvent> recorded = {};
+    for (const st::stepEvent& visit : ns::steps(grid, {0, 0}, {119, 119})) {
+        recorded.push_back(visit);
+    }
+    for (const st::stepEvent& visit : ds::steps(grid, {119, 0}, {0, 119})) {
+        recorded.push_back(visit);
+    }
+    // Far jumps, and large changes in the number of waiting cells
+    for (int i = 0; i < 5000; i++) {
+        recorded.push_back({{(int)(rng() % 5000), (int)(rng() % 5000)}, (int)(rng() % 100000)});
+    }
+    assert(recorded.size() > 3 * st::TRACE_CHUNK_STEPS);
+
+    st::solveTrace trace = {};
+    for (const auto& visit : recorded) {
+        st::recordVisit(trace, visit.cell, visit.taskCount);
+    }
+    assert(st::size(trace) == recorded.size());
+    std::size_t decoded = 0;
+    st::forEachVisit(trace, st::size(trace), [&](const std::size_t i, const st::stepEvent& visit) {
+        assert(i == decoded++);
+        assert(visit.cell == recorded[i].cell && visit.taskCount == recorded[i].taskCount);
+    });
+    assert(decoded == recorded.size());
+    const std::size_t chunkEnd = st::TRACE_CHUNK_STEPS;
+    for (const std::size_t i : {(std::size_t)0, chunkEnd / 2, chunkEnd - 1, chunkEnd, recorded.size() - 1}) {
+        const st::stepEvent visit = st::stepAt(trace, i);
+        assert(visit.cell == recorded[i].cell && visit.taskCount == recorded[i].taskCount);
+    }
+
+    st::clear(trace);
+    assert(st::size(trace) == 0);
+    return 0;
+}
+
+// The landmark bound never overestimates, is exact from a landmark, and lets A* find shortest paths with fewer visits
+int testLandmarks() {
+    std::mt19937 rng(5);
+    auto grid = utils::createEmptyGrid(40, 40);
+    rb::generateMazeIteratively(&grid, rng);
+    for (int i = 0; i < 40; i++) {
+        utils::setWall(grid, {(int)(rng() % 39), (int)(rng() % 39)}, constants::EAST, true);
+    }
+
+    const auto table = lm::build(grid, 4);
+    assert(table.landmarks.size() == 4 && table.distance.size() == 4);
+    for (std::size_t i = 1; i < table.landmarks.size(); i++) {
+        assert(!(table.landmarks[i] == table.landmarks[i - 1]));
+    }
+    const auto rebuilt = lm::build(grid, table.landmarks, 3);
+    assert(rebuilt.distance == table.distance);
+
+    long long manhattanVisits = 0, landmarkVisits = 0;
+    for (int query = 0; query < 20; query++) {
+        const utils::XY start = {(int)(rng() % 40), (int)(rng() % 40)};
+        const utils::XY end = {(int)(rng() % 40), (int)(rng() % 40)};
+        const auto field = df::compute(grid, end);
+        const int distance = field.distance[utils::cellIndex(grid, start)];
+        assert(lm::lowerBound(table, start, end) <= distance);
+        const int fromLandmark = field.distance[utils::cellIndex(grid, table.landmarks[0])];
+        assert(lm::lowerBound(table, table.landmarks[0], end) == fromLandmark);
+
+        as::useLandmarks(nullptr);
+        assert(as::solve(grid, start, end).length == distance + 1);
+        manhattanVisits += as::visitedCount();
+        as::useLandmarks(&table);
+        const auto path = as::solve(grid, start, end);
+        landmarkVisits += as::visitedCount();
+        assert(pp::endOf(path) == end && path.length == distance + 1);
+    }
+    assert(landmarkVisits < manhattanVisits);
+
+    // A table only fits the maze it was built for
+    bool threw = false;
+    try {
+        as::solve(createSnakeMaze(), {0, 0}, {2, 2});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    as::useLandmarks(nullptr);
+    as::reset();
+    return 0;
+}
+
+// Drawing a search one visit at a time keeps the visits which have left the tail in the color they had as they left it,
+// and fades the rest as usual. Drawing it a frame at a time only draws the cells which changed.
+int testTraceView() {
+    std::mt19937 rng(11);
+    auto grid = utils::createEmptyGrid(10, 10);
+    rb::generateMazeIteratively(&grid, rng);
+    auto frame = rd::makeCanvas(10 * constants::CELLWIDTH, 10 * constants::CELLHEIGHT);
+    rd::useCanvas(&frame);
+
+    auto view = st::_openTraceView(grid);
+    std::vector<utils::XY> visited = {};
+    std::vector<std::vector<Color>> wholeFrames = {};
+    for (const st::stepEvent& visit : ns::steps(grid, {0, 0}, {9, 9})) {
+        st::_traceDraw(view, visit, {9, 9}, false);
+        visited.push_back(visit.cell);
+        wholeFrames.push_back(frame.pixels);
+    }
+    assert(visited.size() > st::VISIT_TAIL_LENGTH && view.visitCount == visited.size());
+
+    const int last = visited.size() - 1;
+    for (int i = 0; i <= last; i++) {
+        const int settledAt = i + (int)st::VISIT_TAIL_LENGTH;
+        Color expected = constants::cellFocusColor;
+        if (i < last) {
+            expected = utils::gradateColor(constants::cellFocusColor, RAYWHITE, i, settledAt <= last ? settledAt : last);
+        }
+        const Color drawn = rd::pixelAt(frame, visited[i].x * constants::CELLWIDTH + constants::CELLWIDTH / 2,
+                                        visited[i].y * constants::CELLHEIGHT + constants::CELLHEIGHT / 2);
+        assert(drawn.r == expected.r && drawn.g == expected.g && drawn.b == expected.b && drawn.a == expected.a);
+    }
+    st::_closeTraceView(view);
+
+    // Drawn a frame at a time, only the tail is drawn again, which gives the same pixels as drawing every frame whole
+    view = st::_openTraceView(grid);
+    std::size_t frameIdx = 0;
+    long long dirtyPixels = 0;
+    for (const st::stepEvent& visit : ns::steps(grid, {0, 0}, {9, 9})) {
+        rd::beginFrame();
+        st::_traceDraw(view, visit, {9, 9}, false);
+        rd::endFrame();
+        const rd::frameRect dirty = rd::dirtyRect();
+        dirtyPixels += (long long)(dirty.right - dirty.left) * (dirty.bottom - dirty.top);
+        const std::vector<Color>& whole = wholeFrames.at(frameIdx++);
+        assert(std::memcmp(frame.pixels.data(), whole.data(), whole.size() * sizeof(Color)) == 0);
+    }
+    assert(frameIdx == wholeFrames.size());
+    assert(dirtyPixels < (long long)frameIdx * frame.width * frame.height);
+    st::_closeTraceView(view);
+    rd::useCanvas(nullptr);
+    ns::reset();
+    return 0;
+}
+
+// Stepping through a search lazily visits the same cells as solving it, without recording them
+int testSolverSteps() {
+    auto grid = createSnakeMaze();
+    ws::reset();
+    ws::solve(grid, {0, 0}, {2, 2});
+    const int solvedVisits = ws::visitedCount();
+
+    std::vector<st::stepEvent> visits = {};
+    for (const st::stepEvent& visit : ws::steps(grid, {0, 0}, {2, 2})) {
+        visits.push_back(visit);
+    }
+    assert((int)visits.size() == solvedVisits);
+    assert(visits.front().cell == utils::XY(0, 0));
+    assert(visits.back().cell == utils::XY(2, 2));
+    assert(visits.back().taskCount == 0);
+    assert(ws::visitedCount() == 0);
+
+    // Abandoning a walk part way through is fine, and it throws straight away if given bad locations
+    auto walk = ns::steps(grid, {0, 0}, {2, 2});
+    assert((*walk.begin()).cell == utils::XY(0, 0));
+    bool threw = false;
+    try {
+        ns::steps(grid, {0, 0}, {3, 3});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    ws::reset();
+    return 0;
+}
+
+// IDA* and fringe search find shortest paths, with and without a transposition table, in mazes with and without loops
+int testMemoryBoundedSolvers() {
+    const auto snake = createSnakeMaze();
+    const auto snakeCells = utils::readerFor(snake);
+    for (const std::size_t tableBytes : {(std::size_t)0, (std::size_t)256}) {
+        assert(pp::unpack(mb::idaStar(snakeCells, {0, 0}, {2, 2}, tableBytes).path) == SNAKE_MAZE_SOLUTION);
+        assert(pp::unpack(mb::fringeSearch(snakeCells, {0, 0}, {2, 2}, tableBytes).path) == SNAKE_MAZE_SOLUTION);
+    }
+    assert(mb::idaStar(snakeCells, {1, 1}, {1, 1}).path.length == 1);
+
+    std::mt19937 rng(11);
+    auto grid = utils::createEmptyGrid(30, 30);
+    rb::generateMazeIteratively(&grid, rng);
+    // Knock through some walls, so that there are loops, and so more than one route to some cells
+    for (int i = 0; i < 60; i++) {
+        const utils::XY cell = {(int)(rng() % 29), (int)(rng() % 29)};
+        utils::setWall(grid, cell, rng() % 2 == 0 ? constants::EAST : constants::SOUTH, true);
+    }
+    const auto cells = utils::readerFor(grid);
+    for (int query = 0; query < 10; query++) {
+        const utils::XY start = {(int)(rng() % 30), (int)(rng() % 30)};
+        const utils::XY end = {(int)(rng() % 30), (int)(rng() % 30)};
+        const long long shortest = df::compute(grid, end).distance[utils::cellIndex(grid, start)] + 1;
+        for (const std::size_t tableBytes : {(std::size_t)0, (std::size_t)1024}) {
+            const auto ida = mb::idaStar(cells, start, end, tableBytes);
+            const auto fringe = mb::fringeSearch(cells, start, end, tableBytes);
+            assert(ida.path.length == shortest && fringe.path.length == shortest);
+            assert(pp::endOf(ida.path) == end && pp::endOf(fringe.path) == end);
+            for (const auto* path : {&ida.path, &fringe.path}) {
+                utils::XY previous = start;
+                for (const utils::XY& cell : *path) {
+                    assert(cell == start || utils::isConnected(grid, previous, utils::directionTo(previous, cell)));
+                    previous = cell;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// Both hands find the exit of a perfect maze. The left hand explores the dead ends on its way, the right hand doesn't.
+int testWallFollower() {
+    const auto grid = createSnakeMaze();
+    const auto cells = utils::readerFor(grid);
+
+    pp::packedPath route;
+    const auto leftHand = wf::solve(cells, {0, 0}, {2, 2}, constants::LEFT_HAND, &route);
+    assert(leftHand.found);
+    // The dead ends drop out of the recorded route
+    assert(pp::unpack(route) == SNAKE_MAZE_SOLUTION);
+    const auto rightHand = wf::solve(cells, {0, 0}, {2, 2}, constants::RIGHT_HAND);
+    assert(rightHand.found);
+    assert(rightHand.steps == (long long)SNAKE_MAZE_SOLUTION.size() - 1);
+    assert(leftHand.steps > rightHand.steps);
+
+    return 0;
+}
+
+// The snake maze has nodes at its three dead ends and its one junction. Queries may start and end inside corridors,
+// as well as on nodes.
+int testJunctionGraph() {
+    const auto grid = createSnakeMaze();
+    const auto graph = jg::build(grid);
+    assert(graph.nodeCells.size() == 4);
+    assert(graph.edgeOffsets.size() == graph.nodeCells.size() + 1);
+
+    assert(pp::unpack(jg::solve(graph, grid, {0, 0}, {2, 2}).path) == SNAKE_MAZE_SOLUTION);
+
+    // Both locations lie inside the same corridor
+    const std::vector<utils::XY> withinCorridor = {{1, 1}, {0, 1}, {0, 2}, {1, 2}};
+    assert(pp::unpack(jg::solve(graph, grid, {1, 1}, {1, 2}).path) == withinCorridor);
+
+    // From a corridor, via the junction, into a dead end
+    const std::vector<utils::XY> viaJunction = {{0, 1}, {1, 1}, {1, 0}, {2, 0}};
+    assert(pp::unpack(jg::solve(graph, grid, {0, 1}, {2, 0}).path) == viaJunction);
+
+    return 0;
+}
+
+// The path index answers queries in either direction, and rejects mazes which aren't trees
+int testTreePathIndex() {
+    auto grid = createSnakeMaze();
+    const auto index = tp::build(grid);
+    assert(tp::distance(index, {0, 0}, {2, 2}) == 6);
+    assert(tp::distance(index, {2, 0}, {2, 1}) == 7);
+    assert(tp::distance(index, {1, 1}, {1, 1}) == 0);
+    assert(pp::unpack(tp::path(index, {0, 0}, {2, 2})) == SNAKE_MAZE_SOLUTION);
+
+    auto reversed = SNAKE_MAZE_SOLUTION;
+    std::reverse(reversed.begin(), reversed.end());
+    assert(pp::unpack(tp::path(index, {2, 2}, {0, 0})) == reversed);
+
+    // In a maze one cell wide, vertical steps differ by one index, as horizontal ones do in wider mazes
+    auto corridor = utils::createEmptyGrid(3, 1);
+    corridor.at(0).at(0) = constants::SOUTH;
+    corridor.at(1).at(0) = constants::SOUTH;
+    const auto corridorIndex = tp::build(corridor);
+    assert(pp::unpack(tp::path(corridorIndex, {0, 0}, {0, 2})) == (std::vector<utils::XY>{{0, 0}, {0, 1}, {0, 2}}));
+    assert(pp::unpack(tp::path(corridorIndex, {0, 2}, {0, 0})) == (std::vector<utils::XY>{{0, 2}, {0, 1}, {0, 0}}));
+
+    // Locations outside the maze are rejected rather than read past the index
+    for (const utils::XY outside : {utils::XY{3, 0}, utils::XY{0, -1}}) {
+        bool rejected = false;
+        try {
+            tp::distance(index, {0, 0}, outside);
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected);
+    }
+
+    // Opening the wall between the two dead ends creates a loop
+    grid.at(0).at(2) += constants::SOUTH;
+    bool threw = false;
+    try {
+        tp::build(grid);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+
+    return 0;
+}
+
+// Every cell's path to the target follows the field, and the field is only computed again once some grid changes
+int testDistanceField() {
+    const auto grid = createSnakeMaze();
+    const auto field = df::fieldFor(grid, {2, 2});
+    assert(field->distance.at(0) == 6);
+    assert(field->maxDistance == 6);
+    assert(pp::unpack(df::pathFrom(*field, {0, 0})) == SNAKE_MAZE_SOLUTION);
+    assert(df::pathFrom(*field, {2, 2}).length == 1);
+    assert(df::fieldFor(grid, {2, 2}) == field);
+
+    // Changing a wall makes the cached fields stale, so the next lookup sees the new walls. A field already handed
+    // out stays as it was.
+    auto editable = createSnakeMaze();
+    const auto before = df::fieldFor(editable, {2, 2});
+    utils::setWall(editable, {0, 0}, constants::SOUTH, true);
+    assert(df::fieldFor(editable, {2, 2})->distance.at(0) == 4);
+    assert(before->distance.at(0) == 6);
+
+    // A maze generated again in the same grid, at the same size, doesn't get the old maze's field
+    std::mt19937 rng(5);
+    auto regenerated = utils::createEmptyGrid(8, 8);
+    rb::generateMazeIteratively(&regenerated, rng);
+    const auto first = df::fieldFor(regenerated, {0, 0});
+    regenerated = utils::createEmptyGrid(8, 8);
+    rb::generateMazeIteratively(&regenerated, rng);
+    const auto second = df::fieldFor(regenerated, {0, 0});
+    assert(second != first && second->distance == df::compute(regenerated, {0, 0}).distance);
+
+    // Clearing the cache doesn't free fields which are still held
+    df::clearCache();
+    assert(field->distance.at(0) == 6);
+    return 0;
+}
+
+// With clusters smaller than the maze, the path has to be pieced together across cluster borders
+int testHierarchicalSolver() {
+    const auto grid = createSnakeMaze();
+    for (int clusterSize = 1; clusterSize <= 3; clusterSize++) {
+        const auto graph = hp::build(grid, clusterSize, 2);
+        assert(pp::unpack(hp::solve(graph, grid, {0, 0}, {2, 2}).path) == SNAKE_MAZE_SOLUTION);
+    }
+
+    return 0;
+}
+
+// Opening and closing walls through utils::setWall should update the planner's path, without it being told directly
+int testIncrementalPlanner() {
+    auto grid = createSnakeMaze();
+    ip::planner plan;
+    ip::initialize(plan, grid, {0, 0}, {2, 2});
+    ip::attach(plan);
+    assert(pp::unpack(ip::path(plan)) == SNAKE_MAZE_SOLUTION);
+
+    // A shortcut through the dead end at (2,1)
+    utils::setWall(grid, {1, 1}, constants::EAST, true);
+    const std::vector<utils::XY> shortcut = {{0, 0}, {1, 0}, {1, 1}, {2, 1}, {2, 2}};
+    assert(pp::unpack(ip::path(plan)) == shortcut);
+
+    utils::setWall(grid, {1, 1}, constants::EAST, false);
+    assert(pp::unpack(ip::path(plan)) == SNAKE_MAZE_SOLUTION);
+
+    // Cut the only path
+    utils::setWall(grid, {0, 1}, constants::SOUTH, false);
+    assert(ip::path(plan).length == 0);
+
+    // Once detached, edits are no longer seen
+    ip::detach(plan);
+    utils::setWall(grid, {0, 1}, constants::SOUTH, true);
+    assert(ip::path(plan).length == 0);
+
+    return 0;
+}
+
+// Every job solves its maze, and its result depends only on its seed, not on the worker that ran it
+int testBatch() {
+    const auto serial = bt::run(12, 6, 9, 1, 7);
+    const auto parallel = bt::run(12, 6, 9, 3, 7);
+    assert(serial.jobs.size() == 12);
+    for (int i = 0; i < 12; i++) {
+        assert(serial.jobs[i].found);
+        assert(serial.jobs[i].seed == 7u + i);
+        assert(serial.jobs[i].pathLength >= 6 + 9 - 1);
+        assert(parallel.jobs[i].pathLength == serial.jobs[i].pathLength);
+        assert(parallel.jobs[i].cellsVisited == serial.jobs[i].cellsVisited);
+    }
+
+    return 0;
+}
+
+int main() {
+    testDeadEndFilling();
+    testRecursiveSolverPaths();
+    testSolveTrace();
+    testTraceView();
+    testLandmarks();
+    testSolverSteps();
+    testWallFollower();
+    testMemoryBoundedSolvers();
+    testJunctionGraph();
+    testTreePathIndex();
+    testDistanceField();
+    testHierarchicalSolver();
+    testIncrementalPlanner();
+    testBatch();
+
+    lg::flush();
+    std::cout << "All tests succeeded\n";
+    return 0;
+}
@@ -1,8 +1,23 @@
+#include <atomic>
 #include <cassert>  // for assert
 #include <cstdlib>  // for std::abort
+#include <cstdio>   // for std::remove
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <vector>
 #include "../src/constants.cpp"
+#include "../src/log.h"
+#include "../src/overview.h"
+#include "../src/pacing.h"
+#include "../src/packed_path.h"
+#include "../src/render.h"
+#include "../src/simulation.h"
 #include "../src/utils.h"
+#include "../src/video_export.h"
+#include "../src/viewer.h"
+#include "../src/wall_geometry.h"
+#include "../src/wall_layer.h"
 
 int testCreateEmptyGrid() {
     auto grid = utils::createEmptyGrid(5, 5);
@@ -150,13 +165,501 @@ int testReturnAccessibleNeighbors() {
     return 0;
 }
 
+// Test that utils::isConnected treats a wall as open when either cell points to the other
+int testIsConnected() {
+    auto grid = utils::createEmptyGrid(2, 2);
+    grid.at(0).at(0) = constants::EAST;
+    grid.at(1).at(1) = constants::NORTH;
+
+    // The origin points to its neighbor, and the neighbor points to the origin, respectively
+    assert(utils::isConnected(grid, utils::XY{0, 0}, constants::EAST));
+    assert(utils::isConnected(grid, utils::XY{1, 0}, constants::WEST));
+    assert(utils::isConnected(grid, utils::XY{1, 0}, constants::SOUTH));
+    assert(!utils::isConnected(grid, utils::XY{0, 0}, constants::SOUTH));
+
+    // Neighbors outside the grid are never connected, even if the origin points at them
+    grid.at(0).at(0) += constants::NORTH;
+    assert(!utils::isConnected(grid, utils::XY{0, 0}, constants::NORTH));
+
+    return 0;
+}
+
+// Paths survive packing, reversal and a round trip through a file, including paths whose steps don't fill their last
+// byte
+int testPackedPath() {
+    const std::vector<utils::XY> cells = {{2, 2}, {2, 1}, {3, 1}, {3, 2}, {3, 3}, {2, 3}, {1, 3}};
+    const auto path = pp::pack(cells);
+    assert(path.length == 7);
+    assert(path.steps.size() == 2);
+    assert(pp::unpack(path) == cells);
+    assert(pp::endOf(path) == (utils::XY{1, 3}));
+
+    std::vector<utils::XY> backwards(cells.rbegin(), cells.rend());
+    assert(pp::unpack(pp::reversed(path)) == backwards);
+
+    // Stepping straight back undoes the previous step
+    auto walk = pp::startingAt({0, 0});
+    pp::appendRetracing(walk, constants::EAST);
+    pp::appendRetracing(walk, constants::SOUTH);
+    pp::appendRetracing(walk, constants::NORTH);
+    pp::appendRetracing(walk, constants::EAST);
+    assert(pp::unpack(walk) == (std::vector<utils::XY>{{0, 0}, {1, 0}, {2, 0}}));
+
+    const char* filename = "test_packed_path.bin";
+    pp::writePath(path, filename);
+    assert(pp::readPath(filename) == path);
+    std::remove(filename);
+
+    assert(pp::unpack(pp::pack({})).empty());
+    return 0;
+}
+
+static bool sameColor(const Color a, const Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+// Frames drawn without a window cover the pixels they would in one, and blend translucent colors as it does
+int testHeadlessCanvas() {
+    auto frame = rd::makeCanvas(8, 6);
+    rd::useCanvas(&frame);
+    assert(rd::isHeadless());
+    rd::clear(RAYWHITE);
+
+    // Lines cover the pixels from their start up to, but not including, their end
+    rd::line(1, 2, 5, 2, BLACK);
+    rd::line(7, 6, 7, 3, BLACK);
+    for (int x = 0; x < 8; x++) {
+        assert(sameColor(rd::pixelAt(frame, x, 2), x >= 1 && x < 5 ? BLACK : RAYWHITE));
+    }
+    for (int y = 0; y < 6; y++) {
+        assert(sameColor(rd::pixelAt(frame, 7, y), y >= 3 ? BLACK : RAYWHITE));
+    }
+
+    // Rectangles are clipped to the canvas, and translucent ones are blended into what's below them
+    rd::rectangle(-2, 4, 4, 10, {255, 0, 0, 255});
+    assert(sameColor(rd::pixelAt(frame, 1, 5), {255, 0, 0, 255}));
+    assert(sameColor(rd::pixelAt(frame, 2, 5), RAYWHITE));
+    rd::rectangle(0, 0, 1, 1, {0, 0, 255, 51});
+    assert(sameColor(rd::pixelAt(frame, 0, 0), {196, 196, 247, 255}));
+
+    rd::useCanvas(nullptr);
+    assert(!rd::isHeadless());
+    return 0;
+}
+
+// Redrawing the walls around the cells which changed leaves the same pixels as drawing every wall again
+int testWallLayer() {
+    auto frame = rd::makeCanvas(5 * constants::CELLWIDTH + 1, 4 * constants::CELLHEIGHT + 1);
+    rd::useCanvas(&frame);
+    auto grid = utils::createEmptyGrid(4, 5);
+    auto walls = wl::load(grid, BLACK);
+    const utils::XY opened[][2] = {{{0, 0}, {1, 0}}, {{1, 0}, {1, 1}}, {{4, 3}, {3, 3}}, {{2, 2}, {2, 1}}};
+    for (const auto& cells : opened) {
+        utils::setWall(grid, cells[0], utils::directionTo(cells[0], cells[1]), true);
+        wl::redrawCell(walls, cells[0]);
+        wl::redrawCell(walls, cells[1]);
+    }
+    utils::setWall(grid, {2, 2}, constants::NORTH, false);
+    wl::redrawCell(walls, {2, 2});
+
+    auto expected = wl::load(grid, BLACK);
+    assert(walls.walls.pixels.width == expected.walls.pixels.width);
+    const auto& drawn = walls.walls.pixels.pixels;
+    const auto& redrawn = expected.walls.pixels.pixels;
+    for (std::size_t i = 0; i < drawn.size(); i++) {
+        assert(sameColor(drawn[i], redrawn[i]));
+    }
+    // The wall between the first two cells is gone, and the one on the east edge of the maze is still there
+    assert(rd::pixelAt(walls.walls.pixels, constants::CELLWIDTH, constants::CELLHEIGHT / 2).a == 0);
+    assert(sameColor(rd::pixelAt(walls.walls.pixels, 5 * constants::CELLWIDTH, 0), BLACK));
+
+    wl::unload(walls);
+    wl::unload(expected);
+    rd::useCanvas(nullptr);
+    return 0;
+}
+
+// Drawing through a camera moves and scales shapes, keeps walls at least a pixel thick when zoomed out, and the wall
+// layer follows it
+int testCamera() {
+    auto frame = rd::makeCanvas(100, 80);
+    rd::useCanvas(&frame);
+    rd::useCamera({{0, 0}, {40, 40}, 0, 2});
+    rd::clear(WHITE);
+    rd::rectangle(40, 40, 10, 10, BLACK);
+    assert(sameColor(rd::pixelAt(frame, 0, 0), BLACK) && sameColor(rd::pixelAt(frame, 19, 19), BLACK));
+    assert(sameColor(rd::pixelAt(frame, 20, 20), WHITE));
+
+    rd::useCamera({{0, 0}, {0, 0}, 0, 0.25f});
+    rd::clear(WHITE);
+    rd::line(40, 0, 40, 80, BLACK);
+    assert(sameColor(rd::pixelAt(frame, 10, 5), BLACK));
+    assert(sameColor(rd::pixelAt(frame, 11, 5), WHITE) && sameColor(rd::pixelAt(frame, 10, 20), WHITE));
+    // The frame shows 10 by 8 cells, and the cells on either side may reach into it
+    const vw::cellRange visible = vw::visibleCells(100, 100);
+    assert(visible.minX == 0 && visible.minY == 0 && visible.maxX == 11 && visible.maxY == 9);
+
+    auto grid = utils::createEmptyGrid(3, 3);
+    vw::reset();
+    auto walls = wl::load(grid, BLACK);
+    rd::useCamera({{0, 0}, {float(constants::CELLWIDTH), 0}, 0, 1});
+    rd::clear(WHITE);
+    wl::draw(walls);
+    // The east walls of the first two columns
+    assert(sameColor(rd::pixelAt(frame, 0, 10), BLACK));
+    assert(sameColor(rd::pixelAt(frame, constants::CELLWIDTH, 10), BLACK));
+    assert(sameColor(rd::pixelAt(frame, constants::CELLWIDTH / 2, 10), WHITE));
+
+    wl::unload(walls);
+    vw::reset();
+    rd::useCanvas(nullptr);
+    return 0;
+}
+
+static bool sameTotals(const ov::pyramid& a, const ov::pyramid& b) {
+    if (a.cells != b.cells || a.levels.size() != b.levels.size()) {
+        return false;
+    }
+    for (std::size_t k = 0; k < a.levels.size(); k++) {
+        if (a.levels[k].walls != b.levels[k].walls || a.levels[k].visited != b.levels[k].visited ||
+            a.levels[k].solution != b.levels[k].solution) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Each level of the overview sums up the one below, whether it's built on one thread or several, and stays up to date
+// as walls are opened and cells visited
+int testOverview() {
+    srand(3);
+    auto grid = utils::createEmptyGrid(13, 21);
+    auto carve = [&grid](const int count) {
+        for (int i = 0; i < count; i++) {
+            const utils::XY cell = {rand() % 21, rand() % 13};
+            const int direction = constants::DIRECTIONS[rand() % 4];
+            const utils::XY neighbor = utils::neighborOf(cell, direction);
+            if (neighbor.x >= 0 && neighbor.y >= 0 && utils::inBounds(grid, neighbor)) {
+                utils::setWall(grid, cell, direction, true);
+            }
+        }
+    };
+    carve(100);
+    auto overview = ov::build(grid, 1);
+    assert(sameTotals(overview, ov::build(grid, 3)));
+    // Blocks of 2, 4, 8, 16 and 32 cells, the last covering the whole maze
+    assert(overview.levels.size() == 5 && overview.levels.back().rows == 1 && overview.levels.back().cols == 1);
+    std::uint32_t walls = 0;
+    for (int y = 0; y < 13; y++) {
+        for (int x = 0; x < 21; x++) {
+            walls += !utils::isConnected(grid, {x, y}, constants::EAST);
+            walls += !utils::isConnected(grid, {x, y}, constants::SOUTH);
+        }
+    }
+    assert(overview.levels.back().walls[0] == walls);
+
+    // Opening walls and updating the cells around them leaves the same totals as building the overview again
+    for (int i = 0; i < 50; i++) {
+        const utils::XY cell = {rand() % 21, rand() % 13};
+        const int direction = constants::DIRECTIONS[rand() % 4];
+        const utils::XY neighbor = utils::neighborOf(cell, direction);
+        if (neighbor.x >= 0 && neighbor.y >= 0 && utils::inBounds(grid, neighbor)) {
+            utils::setWall(grid, cell, direction, true);
+            ov::updateWalls(overview, grid, cell);
+            ov::updateWalls(overview, grid, neighbor);
+        }
+    }
+    assert(sameTotals(overview, ov::build(grid, 2)));
+
+    // Cells are only counted once, however often they're visited
+    ov::markVisited(overview, {20, 12});
+    ov::markVisited(overview, {20, 12});
+    ov::markSolution(overview, {0, 0});
+    assert(overview.levels.back().visited[0] == 1 && overview.levels.back().solution[0] == 1);
+    assert(overview.levels[0].visited[6 * overview.levels[0].cols + 10] == 1);
+
+    // The overview takes over from the cells once they're smaller than a pixel
+    rd::useCamera({{0, 0}, {0, 0}, 0, 1.0f / constants::CELLWIDTH});
+    assert(vw::detailLevel() == 0);
+    rd::useCamera({{0, 0}, {0, 0}, 0, 0.5f / constants::CELLWIDTH});
+    assert(vw::detailLevel() == 1);
+    rd::useCamera({{0, 0}, {0, 0}, 0, 0.2f / constants::CELLWIDTH});
+    assert(vw::detailLevel() == 3);
+
+    // Zoomed out, a block of cells which own every wall is drawn in the wall color, and visiting its cells tints it
+    auto frame = rd::makeCanvas(10, 10);
+    rd::useCanvas(&frame);
+    rd::useCamera({{0, 0}, {0, 0}, 0, 0.5f / constants::CELLWIDTH});
+    auto walled = utils::createEmptyGrid(4, 4);
+    auto layer = wl::load(walled, BLACK);
+    for (const utils::XY cell : {utils::XY{0, 0}, utils::XY{1, 0}, utils::XY{0, 1}, utils::XY{1, 1}}) {
+        ov::markVisited(layer.overview, cell);
+    }
+    rd::clear(WHITE);
+    wl::draw(layer);
+    assert(sameColor(rd::pixelAt(frame, 1, 0), BLACK) && sameColor(rd::pixelAt(frame, 1, 1), BLACK));
+    const Color tinted = rd::pixelAt(frame, 0, 0);
+    assert(!sameColor(tinted, BLACK) && !sameColor(tinted, WHITE));
+    assert(sameColor(rd::pixelAt(frame, 2, 0), WHITE));
+
+    wl::unload(layer);
+    vw::reset();
+    rd::useCanvas(nullptr);
+    return 0;
+}
+
+static bool sameSpans(const std::vector<std::vector<wg::span>>& a, const std::vector<std::vector<wg::span>>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t line = 0; line < a.size(); line++) {
+        if (a[line].size() != b[line].size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < a[line].size(); i++) {
+            if (a[line][i].start != b[line][i].start || a[line][i].end != b[line][i].end) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Listeners hear about every wall setWall changes, and can remove themselves while being called
+int testWallListeners() {
+    auto grid = utils::createEmptyGrid(2, 2);
+    int heard = 0;
+    int listenerId = -1;
+    listenerId = utils::addWallListener([&](const utils::gridType&, const utils::XY& a, const utils::XY& b) {
+        assert(a == (utils::XY{0, 0}) && b == (utils::XY{1, 0}));
+        heard++;
+        utils::removeWallListener(listenerId);
+    });
+    utils::setWall(grid, {0, 0}, constants::EAST, true);
+    utils::setWall(grid, {0, 0}, constants::SOUTH, true);
+    assert(heard == 1);
+    return 0;
+}
+
+// Walls in a straight line are merged into one segment, and removing walls one at a time leaves the same segments as
+// building them again
+int testWallGeometry() {
+    // Every wall of an empty grid is standing, so each line inside or on the south and east edges is one segment
+    auto grid = utils::createEmptyGrid(3, 4);
+    auto geometry = wg::build(grid);
+    assert(wg::segmentCount(geometry) == 3 + 4);
+    assert(geometry.horizontal[0].empty() && geometry.vertical[0].empty());
+    assert(geometry.horizontal[2].size() == 1 && geometry.horizontal[2][0].start == 0);
+    assert(geometry.horizontal[2][0].end == 4);
+
+    // Opening a wall in the middle of a segment splits it, and at its end shortens it
+    utils::setWall(grid, {1, 1}, constants::SOUTH, true);
+    wg::removeWall(geometry, {1, 1}, constants::SOUTH);
+    utils::setWall(grid, {0, 0}, constants::EAST, true);
+    wg::removeWall(geometry, {1, 0}, constants::WEST);
+    assert(geometry.horizontal[2].size() == 2);
+    assert(geometry.vertical[1].size() == 1 && geometry.vertical[1][0].start == 1);
+    assert(sameSpans(geometry.horizontal, wg::build(grid).horizontal));
+    assert(sameSpans(geometry.vertical, wg::build(grid).vertical));
+    // The north and west edges have no walls to remove, and a wall already removed stays removed
+    wg::removeWall(geometry, {0, 0}, constants::NORTH);
+    wg::removeWall(geometry, {1, 1}, constants::SOUTH);
+    assert(wg::segmentCount(geometry) == wg::segmentCount(wg::build(grid)));
+
+    // Carve random passages through a larger grid
+    srand(7);
+    auto large = utils::createEmptyGrid(20, 30);
+    auto updated = wg::build(large);
+    for (int i = 0; i < 400; i++) {
+        const utils::XY cell = {rand() % 30, rand() % 20};
+        const int direction = constants::DIRECTIONS[rand() % 4];
+        const utils::XY neighbor = utils::neighborOf(cell, direction);
+        if (neighbor.x < 0 || neighbor.y < 0 || !utils::inBounds(large, neighbor)) {
+            continue;
+        }
+        utils::setWall(large, cell, direction, true);
+        wg::removeWall(updated, cell, direction);
+    }
+    const auto rebuilt = wg::build(large);
+    assert(sameSpans(updated.horizontal, rebuilt.horizontal));
+    assert(sameSpans(updated.vertical, rebuilt.vertical));
+
+    std::ostringstream svg;
+    wg::writeSvg(rebuilt, svg, 10, 10, RAYWHITE, BLACK);
+    assert(svg.str().find("<path") != std::string::npos);
+    assert(svg.str().find("</svg>") != std::string::npos);
+    return 0;
+}
+
+// Changes published by the simulation thread reach the render thread in order, none lost, however often each side looks
+int testSimulation() {
+    sm::doubleBuffer<int, int> updates;
+    sm::update<int, int> latest;
+    assert(!updates.take(latest));
+    updates.record(1);
+    updates.back.status = 1;
+    updates.publish();
+    updates.record(2);
+    updates.back.status = 2;
+    updates.publish();
+    assert(updates.take(latest) && latest.changes == std::vector<int>({1, 2}) && latest.status == 2);
+    assert(!updates.take(latest) && latest.changes.empty() && latest.status == 2);
+
+    // Run as fast as possible, the worker takes every step and publishes the last of them before it finishes
+    std::atomic<int> steps = 0;
+    std::vector<int> seen = {};
+    sm::worker simulation;
+    simulation.start(
+        [&]() {
+            updates.record(steps++);
+            return steps < 10000;
+        },
+        [&]() { updates.publish(); }, 0);
+    while (!simulation.finished()) {
+        updates.take(latest);
+        seen.insert(seen.end(), latest.changes.begin(), latest.changes.end());
+    }
+    updates.take(latest);
+    seen.insert(seen.end(), latest.changes.begin(), latest.changes.end());
+    assert(steps == 10000 && seen.size() == 10000 && seen.back() == 9999);
+
+    // A throttled worker takes its first step straight away, and can be stopped part way through
+    steps = 0;
+    simulation.start(
+        [&]() {
+            steps++;
+            return true;
+        },
+        []() {}, 1);
+    while (steps == 0) {
+    }
+    simulation.stop();
+    assert(simulation.finished() && steps < 3);
+    return 0;
+}
+
+// Without a window, a frame takes all of its steps, however long they take, unless the animation runs out of them first
+int testPacing() {
+    auto frame = rd::makeCanvas(1, 1);
+    rd::useCanvas(&frame);
+    pc::begin(1000, 60);
+    const long long quota = pc::stepsThisFrame();
+    long long steps = 0;
+    assert(pc::advance([&steps]() {
+        steps++;
+        return true;
+    }));
+    assert(quota >= 1 && steps == quota);
+    steps = 0;
+    assert(!pc::advance([&steps]() { return ++steps < 1; }) && steps == 1);
+    rd::useCanvas(nullptr);
+    return 0;
+}
+
+// A running process always holds some memory, and holds more once it has touched more
+int testResidentMemory() {
+    const long before = utils::residentMemoryKb();
+    std::vector<char> touched(64 << 20, 1);
+    const long after = utils::residentMemoryKb();
+    assert(before > 0 && after >= before + (32 << 10) && touched.back() == 1);
+    return 0;
+}
+
+static std::string readFile(const char* filename) {
+    std::ifstream file(filename, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// A frame marked dirty in places only draws there, and each video frame after the first only converts the rectangle it
+// is told changed. The files come out whole.
+int testVideoExport() {
+    auto frame = rd::makeCanvas(6, 4);
+    rd::useCanvas(&frame);
+    // The first frame, and any frame which marks nothing before drawing, is drawn whole
+    rd::beginFrame();
+    rd::clear(BLACK);
+    rd::endFrame();
+    rd::frameRect dirty = rd::dirtyRect();
+    assert(dirty.left == 0 && dirty.top == 0 && dirty.right == 6 && dirty.bottom == 4);
+    rd::beginFrame();
+    rd::markDirty(1, 1, 1, 1);
+    rd::markDirty(3, 2, 2, 1);
+    rd::clear(WHITE);
+    rd::endFrame();
+    dirty = rd::dirtyRect();
+    assert(dirty.left == 1 && dirty.top == 1 && dirty.right == 5 && dirty.bottom == 3);
+    assert(rd::pixelAt(frame, 2, 2).r == 255 && rd::pixelAt(frame, 0, 0).r == 0 && rd::pixelAt(frame, 5, 3).r == 0);
+    rd::beginFrame();
+    rd::endFrame();
+    assert(rd::dirtyRect().right == 0);
+    // Once the camera moves, every pixel may change
+    rd::beginFrame();
+    rd::useCamera({{1, 0}, {0, 0}, 0, 1});
+    rd::markDirty(0, 0, 1, 1);
+    rd::endFrame();
+    assert(rd::dirtyRect().right == 6);
+    rd::useCamera({{0, 0}, {0, 0}, 0, 1});
+    rd::useCanvas(&frame);
+
+    // Y4M frames are whole planes, with the pixels outside the changed rectangle kept from the frames before
+    const char* y4mName = "test_video.y4m";
+    vx::videoStream y4m = {};
+    assert(vx::open(y4m, y4mName, 6, 4, 30));
+    rd::clear(BLACK);
+    vx::writeFrame(y4m, frame, {0, 0, 0, 0});
+    rd::rectangle(1, 1, 1, 1, WHITE);
+    rd::rectangle(5, 0, 1, 1, WHITE);
+    vx::writeFrame(y4m, frame, {1, 1, 2, 2});
+    vx::writeFrame(y4m, frame, {0, 0, 0, 0});
+    vx::close(y4m);
+    const std::string video = readFile(y4mName);
+    const std::string header = "YUV4MPEG2 W6 H4 F30:1 Ip A1:1 C420jpeg\n";
+    const std::size_t frameSize = 6 + 6 * 4 + 2 * 3 * 2;
+    assert(video.size() == header.size() + 3 * frameSize);
+    const std::size_t lastFrame = header.size() + 2 * frameSize + 6;
+    assert((unsigned char)video[lastFrame + 1 * 6 + 1] == 255 && video[lastFrame] == 0 && video[lastFrame + 5] == 0);
+    std::remove(y4mName);
+
+    // Each GIF frame after the first is an image of just the changed rectangle
+    const char* gifName = "test_video.gif";
+    vx::videoStream gif = {};
+    assert(vx::open(gif, gifName, 6, 4, 30));
+    vx::writeFrame(gif, frame, {0, 0, 6, 4});
+    rd::rectangle(4, 3, 1, 1, WHITE);
+    vx::writeFrame(gif, frame, {4, 3, 5, 4});
+    vx::writeFrame(gif, frame, {0, 0, 0, 0});
+    vx::close(gif);
+    const std::string animation = readFile(gifName);
+    assert(animation.starts_with("GIF89a") && animation.back() == 0x3B);
+    assert(animation.find(std::string("\x2C\x04\x00\x03\x00\x01\x00\x01\x00", 9)) != std::string::npos);
+    std::remove(gifName);
+
+    rd::useCanvas(nullptr);
+    return 0;
+}
+
 int main() {
     testCreateEmptyGrid();
     testInBounds();
     testInBoundsXY();
     testGradateColor();
     testReturnAccessibleNeighbors();
+    testIsConnected();
+    testPackedPath();
+    testHeadlessCanvas();
+    testWallLayer();
+    testWallListeners();
+    testWallGeometry();
+    testCamera();
+    testOverview();
+    testSimulation();
+    testPacing();
+    testResidentMemory();
+    testVideoExport();
 
+    lg::flush();
     std::cout << "All tests succeeded\n";
     return 0;
 }
\ No newline at end of file